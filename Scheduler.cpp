@@ -41,12 +41,59 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 *  Called once on setup to bring the timer system into a known state.
 */
 Scheduler::Scheduler() {
+#if SCHEDULER_POOL_SIZE == 0
   this->next_pid            = 0x00000001;
+#endif
   this->currently_executing = 0x00000000;
   this->schedule_root_node  = NULL;
+  this->schedule_tail_node  = NULL;
+  for (int p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    this->ready_queue_head[p] = NULL;
+    this->ready_queue_tail[p] = NULL;
+    this->class_deferrals[p]  = 0x00000000;
+  }
   this->productive_loops    = 0x00000000;
   this->total_loops         = 0x00000000;
   this->overhead            = 0x00000000;
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  this->wheel_tick          = 0x00000000;
+  for (int i = 0; i < SCHEDULER_WHEEL_BUCKETS; i++) this->wheel_buckets[i] = NULL;
+#endif
+#if SCHEDULER_DELTA_QUEUE
+  this->delta_root          = NULL;
+#endif
+#if SCHEDULER_PID_TABLE_SIZE > 0
+  for (int i = 0; i < SCHEDULER_PID_TABLE_SIZE; i++) {
+    this->pid_index_keys[i] = 0x00000000;
+    this->pid_index_refs[i] = NULL;
+  }
+#endif
+#if SCHEDULER_ISR_SAFE
+  this->isr_ring_head      = 0;
+  this->isr_ring_tail      = 0;
+  this->isr_ring_overflows = 0x00000000;
+#endif
+  this->deadline_callback   = NULL;
+  this->group_enable_mask   = 0xFFFFFFFF;
+  this->reap_count          = 0;
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  for (int i = 0; i < SCHEDULER_ONESHOT_SLOTS; i++) {
+    this->oneshot_ttw[i]   = 0x00000000;
+    this->oneshot_cb[i]    = NULL;
+    this->oneshot_fired[i] = false;
+    this->oneshot_gen[i]   = 1;
+  }
+  this->oneshot_cursor      = 0;
+#endif
+  this->budget_demotions    = 0x00000000;
+#if SCHEDULER_WATCHDOG_TICKS > 0
+  this->watchdog_callback     = NULL;
+  this->dispatch_seq          = 0x00000000;
+  this->watchdog_mark_seq     = 0x00000000;
+  this->watchdog_ticks_in     = 0x00000000;
+  this->watchdog_stuck_pid    = 0x00000000;
+  this->watchdog_stuck_events = 0x00000000;
+#endif
 }
 
 
@@ -59,24 +106,132 @@ Scheduler::~Scheduler() {
 
 
 
+/****************************************************************************************************
+* Node allocation...                                                                                *
+* Everything the scheduler stores passes through the two functions below. With                      *
+*  SCHEDULER_POOL_SIZE defined non-zero, they are backed by a static pool and free-list instead of  *
+*  the heap: acquisition/release are a couple of pointer swaps, deterministic, and fragmentation-   *
+*  proof. The pool is shared by all Scheduler instances.                                            *
+****************************************************************************************************/
+
+#if SCHEDULER_POOL_SIZE > 0
+#define SCHEDULER_POOL_MAP_WORDS ((SCHEDULER_POOL_SIZE + 31) / 32)
+
+static ScheduleItem      item_pool[SCHEDULER_POOL_SIZE];         // Backing store for ScheduleItems.
+static uint32_t          item_pool_map[SCHEDULER_POOL_MAP_WORDS]; // Free-bitmap. A set bit is a free slot.
+static uint16_t          item_pool_gen[SCHEDULER_POOL_SIZE];     // Per-slot generation. High half of the slot's PIDs.
+static boolean           pools_initialized = false;
+
+/**
+* Marks every pool slot free in the bitmap. Runs once, on the first acquisition.
+*/
+static void initialize_pools() {
+  for (int16_t w = 0; w < SCHEDULER_POOL_MAP_WORDS; w++) item_pool_map[w] = 0xFFFFFFFF;
+  /* Bits past the last real slot in the final word must never read as free. */
+  if (SCHEDULER_POOL_SIZE & 31) {
+    item_pool_map[SCHEDULER_POOL_MAP_WORDS - 1] = (1UL << (SCHEDULER_POOL_SIZE & 31)) - 1;
+  }
+  for (int16_t i = 0; i < SCHEDULER_POOL_SIZE; i++) item_pool_gen[i] = 1;
+  pools_initialized = true;
+}
+
+
+/**
+* The first free slot per the bitmap, or -1 if the pool is exhausted. The word scan is
+*  a handful of iterations at most; the bit within the word is find-first-set, which is
+*  one instruction on ARM and a short table-free sequence on AVR.
+*/
+static int16_t pool_first_free() {
+  for (int16_t w = 0; w < SCHEDULER_POOL_MAP_WORDS; w++) {
+    if (item_pool_map[w] != 0) {
+      return (int16_t) ((w << 5) + __builtin_ctzl(item_pool_map[w]));
+    }
+  }
+  return -1;
+}
+
+
+/**
+* The PID the given slot's current occupant goes by: generation in the high half,
+*  (slot + 1) in the low half. Never zero, and never equal to any PID issued for a
+*  previous occupant of the slot.
+*/
+static uint32_t pool_pid_for_slot(int16_t slot) {
+  return (((uint32_t) item_pool_gen[slot]) << 16) | ((uint32_t) slot + 1);
+}
+#endif  // SCHEDULER_POOL_SIZE > 0
+
+
+/**
+* Hands back a zeroed ScheduleItem, or NULL if storage is exhausted.
+*/
+ScheduleItem* Scheduler::acquireScheduleItem() {
+#if SCHEDULER_POOL_SIZE > 0
+  if (!pools_initialized) initialize_pools();
+  ScheduleItem *return_value  = NULL;
+  int16_t slot = pool_first_free();
+  if (slot >= 0) {
+    item_pool_map[slot >> 5] &= ~(1UL << (slot & 31));
+    return_value = &item_pool[slot];
+  }
+#else
+  ScheduleItem *return_value  = (ScheduleItem *) malloc(sizeof(ScheduleItem));
+#endif
+  if (return_value != NULL) {
+    memset(return_value, 0x00, sizeof(ScheduleItem));
+#if SCHEDULER_WHEEL_BUCKETS > 0
+    return_value->wheel_bucket = -1;   // All-zeroes would mean "filed in bucket 0".
+#endif
+  }
+  return return_value;
+}
+
+
+/**
+* Returns the given ScheduleItem to whichever store it came from.
+*/
+void Scheduler::releaseScheduleItem(ScheduleItem *obj) {
+#if SCHEDULER_POOL_SIZE > 0
+  uint16_t slot  = (uint16_t) (obj - item_pool);
+  obj->pid       = 0;
+  obj->owner     = NULL;   // Makes the slab sweep skip this slot.
+  item_pool_gen[slot]++;   // Stales every PID ever issued against this slot.
+  item_pool_map[slot >> 5] |= (1UL << (slot & 31));
+#else
+  free(obj);
+#endif
+}
+
+
 /****************************************************************************************************
 * Functions dealing with profiling data.                                                            *
+* The stats live inline in the ScheduleItem, so starting a profile allocates nothing and the        *
+*  dispatcher's gate is a single flag test on a struct it is already touching.                      *
 ****************************************************************************************************/
 
 /**
-* Any schedule that has a ScheduleProfile object in the appropriate slot will be profiled.
-*  So to begin profiling a schedule, simply malloc() the appropriate struct into place and initialize it.
+* Begins (or re-begins) profiling the given schedule. A fresh start wipes whatever
+*  stats a previous profiling session left behind; stopping and restarting is how the
+*  counters are re-based. Never fails for a real schedule: there is nothing to allocate.
 */
 void Scheduler::beginProfiling(ScheduleItem *target) {
   if (target != NULL) {
-    if (target->prof_data == NULL) {
-      ScheduleProfile *p_data  = (ScheduleProfile *) malloc(sizeof(ScheduleProfile));
-      target->prof_data = p_data;
+    if (!target->prof_data.profiling_active) {
+      ScheduleProfile *p_data  = &target->prof_data;
       p_data->profiling_active  = true;
       p_data->last_time_micros  = 0x00000000;
       p_data->execution_count   = 0x00000000;
       p_data->worst_time_micros = 0x00000000;
       p_data->best_time_micros  = 0xFFFFFFFF;
+      p_data->budget_micros     = 0x00000000;
+      p_data->budget_overruns   = 0x00000000;
+      p_data->fire_time_micros  = 0x00000000;
+      p_data->latency_last      = 0x00000000;
+      p_data->latency_best      = 0xFFFFFFFF;
+      p_data->latency_worst     = 0x00000000;
+      p_data->latency_total     = 0x00000000;
+      p_data->missed_fires      = 0x00000000;
+      p_data->budget_strikes    = 0;
     }
   }
 }
@@ -98,10 +253,7 @@ void Scheduler::beginProfiling(uint32_t g_pid) {
 */
 void Scheduler::stopProfiling(ScheduleItem *obj) {
   if (obj != NULL) {
-    ScheduleProfile *p_data  = obj->prof_data;
-    if (p_data != NULL) {
-      p_data->profiling_active  = false;
-    }
+    obj->prof_data.profiling_active = false;
   }
 }
 
@@ -120,11 +272,7 @@ void Scheduler::stopProfiling(uint32_t g_pid) {
 */
 void Scheduler::clearProfilingData(ScheduleItem *obj) {
   if (obj != NULL) {
-    ScheduleProfile *p_data  = obj->prof_data;
-    if (p_data != NULL) {
-      free(p_data);
-      p_data = NULL;
-    }
+    memset((void*) &obj->prof_data, 0x00, sizeof(ScheduleProfile));
   }
 }
 
@@ -145,9 +293,7 @@ void Scheduler::clearProfilingData(uint32_t g_pid) {
 */
 boolean Scheduler::scheduleBeingProfiled(ScheduleItem *obj) {
   if (obj != NULL) {
-    if (obj->prof_data != NULL) {
-      return obj->prof_data->profiling_active;
-    }
+    return obj->prof_data.profiling_active;
   }
   return false;
 }
@@ -207,9 +353,27 @@ void Scheduler::destroyAllScheduleItems() {
   while (temp0 != NULL) {
     temp1  = temp0->next;
     this->clearProfilingData(temp0);
-    free(temp0);
+    this->releaseScheduleItem(temp0);
     temp0 = temp1;
   }
+  this->schedule_root_node = NULL;
+  this->schedule_tail_node = NULL;
+  for (int p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    this->ready_queue_head[p] = NULL;
+    this->ready_queue_tail[p] = NULL;
+  }
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  for (int i = 0; i < SCHEDULER_WHEEL_BUCKETS; i++) this->wheel_buckets[i] = NULL;
+#endif
+#if SCHEDULER_DELTA_QUEUE
+  this->delta_root = NULL;
+#endif
+#if SCHEDULER_PID_TABLE_SIZE > 0
+  for (int i = 0; i < SCHEDULER_PID_TABLE_SIZE; i++) {
+    this->pid_index_keys[i] = 0x00000000;
+    this->pid_index_refs[i] = NULL;
+  }
+#endif
 }
 
 
@@ -220,6 +384,7 @@ boolean Scheduler::insertScheduleItemAfterNode(ScheduleItem *nu, ScheduleItem *p
   if (prev != NULL) {
     nu->next    = prev->next;
     prev->next  = nu;
+    if (prev == this->schedule_tail_node) this->schedule_tail_node = nu;
     return true;
   }
   return false;
@@ -227,28 +392,107 @@ boolean Scheduler::insertScheduleItemAfterNode(ScheduleItem *nu, ScheduleItem *p
 
 
 /**
-* Inserts nu at the end of the linked list.
+* Inserts nu at the end of the linked list. O(1), via the cached tail pointer.
 *  Returns true on success, and false on failure. Should never return false if good parameters are given.
 */
 boolean Scheduler::insertScheduleItemAtEnd(ScheduleItem *nu) {
-  if (this->schedule_root_node != NULL) {
-    ScheduleItem *temp  = this->schedule_root_node;
-    while (temp->next != NULL) temp  = temp->next;
-    temp->next  = nu;
+#if SCHEDULER_ISR_SAFE
+  // The node must be fully initialized before the single store that links it in,
+  //  since the tick ISR may walk onto it the instant it becomes reachable.
+  SCHEDULER_MEMORY_BARRIER();
+#endif
+  if (this->schedule_tail_node != NULL) {
+    this->schedule_tail_node->next = nu;
+    this->schedule_tail_node       = nu;
     return true;
   }
   else {
     this->schedule_root_node = nu;
+    this->schedule_tail_node = nu;
   }
   return false;
 }
 
 
+#if SCHEDULER_PID_TABLE_SIZE > 0
+/**
+* Files the given node into the PID index with linear probing. If the table is
+*  completely full, the node simply goes unindexed; findNodeByPID() will still
+*  locate it via the list walk.
+*/
+void Scheduler::pidIndexInsert(ScheduleItem *obj) {
+  uint16_t slot  = obj->pid & (SCHEDULER_PID_TABLE_SIZE - 1);
+  for (uint16_t i = 0; i < SCHEDULER_PID_TABLE_SIZE; i++) {
+    if ((this->pid_index_keys[slot] == 0) || (this->pid_index_refs[slot] == NULL)) {
+      this->pid_index_keys[slot] = obj->pid;
+      this->pid_index_refs[slot] = obj;
+      return;
+    }
+    slot = (slot + 1) & (SCHEDULER_PID_TABLE_SIZE - 1);
+  }
+}
+
+
+/**
+* Tombstones the given PID in the index. The key is left in place so that probe
+*  chains running through this slot are not broken.
+*/
+void Scheduler::pidIndexRemove(uint32_t g_pid) {
+  uint16_t slot  = g_pid & (SCHEDULER_PID_TABLE_SIZE - 1);
+  for (uint16_t i = 0; i < SCHEDULER_PID_TABLE_SIZE; i++) {
+    if (this->pid_index_keys[slot] == 0) return;   // Hit an empty slot. Was never indexed.
+    if (this->pid_index_keys[slot] == g_pid) {
+      this->pid_index_refs[slot] = NULL;
+      return;
+    }
+    slot = (slot + 1) & (SCHEDULER_PID_TABLE_SIZE - 1);
+  }
+}
+
+
+/**
+* Probes the index for the given PID. Returns the node on a hit.
+* Returns NULL on a miss, which means "not indexed", not necessarily "absent".
+*/
+ScheduleItem* Scheduler::pidIndexLookup(uint32_t g_pid) {
+  uint16_t slot  = g_pid & (SCHEDULER_PID_TABLE_SIZE - 1);
+  for (uint16_t i = 0; i < SCHEDULER_PID_TABLE_SIZE; i++) {
+    if (this->pid_index_keys[slot] == 0) return NULL;   // Hit an empty slot. Probe chain ends.
+    if ((this->pid_index_keys[slot] == g_pid) && (this->pid_index_refs[slot] != NULL)) {
+      return this->pid_index_refs[slot];
+    }
+    slot = (slot + 1) & (SCHEDULER_PID_TABLE_SIZE - 1);
+  }
+  return NULL;
+}
+#endif  // SCHEDULER_PID_TABLE_SIZE > 0
+
+
 /**
-* Traverses the linked list and returns a pointer to the node that has the given PID.
+* Returns a pointer to the node that has the given PID.
+* Consults the O(1) PID index first (if enabled), then falls back on traversing
+*  the linked list, since nodes created while the index was full are not indexed.
 * Returns NULL if a node is not found that meets this criteria.
 */
 ScheduleItem* Scheduler::findNodeByPID(uint32_t g_pid) {
+#if SCHEDULER_POOL_SIZE > 0
+  // Pool PIDs encode their slot directly: decode it, then check that the slot's
+  //  occupant still answers to this PID. A recycled slot has a newer generation,
+  //  so a stale handle fails the comparison instead of finding a stranger.
+  uint32_t slot  = g_pid & 0x0000FFFF;
+  if ((slot == 0) || (slot > SCHEDULER_POOL_SIZE)) return NULL;
+  ScheduleItem *candidate  = &item_pool[slot - 1];
+  if ((candidate->owner == (void*) this) && (candidate->pid == g_pid)) {
+    return candidate;
+  }
+  return NULL;
+#else
+#if SCHEDULER_PID_TABLE_SIZE > 0
+  ScheduleItem *indexed  = this->pidIndexLookup(g_pid);
+  if (indexed != NULL) {
+    return indexed;
+  }
+#endif
   ScheduleItem *current  = this->schedule_root_node;
   while (current != NULL) {
     if (current->pid == g_pid) {
@@ -257,6 +501,7 @@ ScheduleItem* Scheduler::findNodeByPID(uint32_t g_pid) {
     current  = current->next;
   }
   return NULL;
+#endif  // SCHEDULER_POOL_SIZE
 }
 
 
@@ -277,7 +522,363 @@ ScheduleItem* Scheduler::findNodeBeforeThisOne(ScheduleItem *target) {
 }
 
 
-/** 
+#if SCHEDULER_WHEEL_BUCKETS > 0
+/****************************************************************************************************
+* Timing-wheel functions...                                                                         *
+* These only exist if SCHEDULER_WHEEL_BUCKETS is defined non-zero. In that mode, every enabled      *
+*  schedule is filed into the bucket corresponding to its expiry tick, and advanceScheduler() only  *
+*  touches the one bucket that is due.                                                              *
+****************************************************************************************************/
+
+/**
+* Files the given item into the wheel bucket in which it will come due.
+*  The ticks_out parameter is a TTW value: to preserve the countdown semantics of the linear
+*  tick path (the schedule fires on the tick after TTW has reached zero), the item actually
+*  expires (ticks_out + 1) ticks from now.
+* The caller is responsible for ensuring the item is not already filed.
+*/
+void Scheduler::wheelInsert(ScheduleItem *obj, uint32_t ticks_out) {
+  uint32_t ticks  = ticks_out + 1;
+  int16_t bucket  = (int16_t) ((this->wheel_tick + ticks) & (SCHEDULER_WHEEL_BUCKETS - 1));
+  obj->wheel_rounds = (ticks - 1) / SCHEDULER_WHEEL_BUCKETS;
+  obj->wheel_bucket = bucket;
+  obj->wheel_prev   = NULL;
+  obj->wheel_next   = this->wheel_buckets[bucket];
+  if (obj->wheel_next != NULL) obj->wheel_next->wheel_prev = obj;
+  this->wheel_buckets[bucket] = obj;
+}
+
+
+/**
+* Unlinks the given item from whatever bucket it is filed in. Safe to call on an
+*  item that is not presently filed.
+*/
+void Scheduler::wheelRemove(ScheduleItem *obj) {
+  if (obj->wheel_bucket >= 0) {
+    if (obj->wheel_prev != NULL) obj->wheel_prev->wheel_next = obj->wheel_next;
+    else this->wheel_buckets[obj->wheel_bucket] = obj->wheel_next;
+    if (obj->wheel_next != NULL) obj->wheel_next->wheel_prev = obj->wheel_prev;
+    obj->wheel_next   = NULL;
+    obj->wheel_prev   = NULL;
+    obj->wheel_bucket = -1;
+  }
+}
+#endif  // SCHEDULER_WHEEL_BUCKETS > 0
+
+
+#if SCHEDULER_DELTA_QUEUE
+/****************************************************************************************************
+* Delta-queue functions...                                                                          *
+* These only exist if SCHEDULER_DELTA_QUEUE is selected. Enabled schedules live in a second chain   *
+*  sorted by time-to-fire, each node's wait stored as a delta from its predecessor. A tick then     *
+*  decrements only the head, so tick cost does not depend on how many schedules are defined.        *
+****************************************************************************************************/
+
+/**
+* Ordered insertion into the delta chain. The ticks_out parameter is a TTW value: as with
+*  the wheel, the item actually comes due (ticks_out + 1) ticks from now, preserving the
+*  countdown semantics of the linear path. Items due on the same tick are kept in
+*  insertion order. The caller is responsible for ensuring the item is not already linked.
+*/
+void Scheduler::deltaInsert(ScheduleItem *obj, uint32_t ticks_out) {
+  uint32_t remaining     = ticks_out + 1;
+  ScheduleItem *prev     = NULL;
+  ScheduleItem *current  = this->delta_root;
+  while ((current != NULL) && (remaining >= current->delta_ttw)) {
+    remaining -= current->delta_ttw;
+    prev       = current;
+    current    = current->delta_next;
+  }
+  obj->delta_ttw    = remaining;
+  obj->delta_next   = current;
+  obj->delta_linked = true;
+  if (current != NULL) current->delta_ttw -= remaining;
+  if (prev != NULL) prev->delta_next = obj;
+  else this->delta_root = obj;
+}
+
+
+/**
+* Unlinks the given item from the delta chain, folding its remaining wait into its
+*  successor so the chain's absolute deadlines are undisturbed. Safe to call on an
+*  item that is not presently linked.
+*/
+void Scheduler::deltaRemove(ScheduleItem *obj) {
+  if (obj->delta_linked) {
+    ScheduleItem *prev     = NULL;
+    ScheduleItem *current  = this->delta_root;
+    while (current != NULL) {
+      if (current == obj) {
+        if (obj->delta_next != NULL) obj->delta_next->delta_ttw += obj->delta_ttw;
+        if (prev != NULL) prev->delta_next = obj->delta_next;
+        else this->delta_root = obj->delta_next;
+        obj->delta_next   = NULL;
+        obj->delta_linked = false;
+        return;
+      }
+      prev    = current;
+      current = current->delta_next;
+    }
+  }
+}
+#endif  // SCHEDULER_DELTA_QUEUE
+
+
+/**
+* Files the item into whatever auxiliary expiry structure the selected tick path uses,
+*  releasing any prior filing first. Called wherever a schedule's expiry is (re)set.
+*  In the default linear mode, there is no such structure and this does nothing.
+*/
+void Scheduler::tickPathAttach(ScheduleItem *obj, uint32_t ticks_out) {
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  this->wheelRemove(obj);
+  this->wheelInsert(obj, ticks_out);
+#elif SCHEDULER_DELTA_QUEUE
+  this->deltaRemove(obj);
+  this->deltaInsert(obj, ticks_out);
+#endif
+}
+
+
+/**
+* Counterpart to the above, called when a schedule stops (disable, destruction).
+*/
+void Scheduler::tickPathDetach(ScheduleItem *obj) {
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  this->wheelRemove(obj);
+#elif SCHEDULER_DELTA_QUEUE
+  this->deltaRemove(obj);
+#endif
+}
+
+
+/**
+* How many ticks until the given (enabled) schedule comes due. The linear path keeps
+*  the live countdown in the item itself, but the wheel and delta paths encode the
+*  deadline in their own structures and leave thread_time_to_wait stale, so anything
+*  that needs a schedule's true remaining wait (coalescing, chiefly) must come here.
+*/
+uint32_t Scheduler::ticksRemaining(ScheduleItem *obj) {
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  if (obj->wheel_bucket >= 0) {
+    uint32_t d  = ((uint32_t)(obj->wheel_bucket - this->wheel_tick)) & (SCHEDULER_WHEEL_BUCKETS - 1);
+    if (d == 0) d = SCHEDULER_WHEEL_BUCKETS;
+    return d + (obj->wheel_rounds * SCHEDULER_WHEEL_BUCKETS);
+  }
+#elif SCHEDULER_DELTA_QUEUE
+  if (obj->delta_linked) {
+    uint32_t ticks         = 0;
+    ScheduleItem *current  = this->delta_root;
+    while (current != NULL) {
+      ticks += current->delta_ttw;
+      if (current == obj) return ticks;
+      current = current->delta_next;
+    }
+  }
+#endif
+  return obj->thread_time_to_wait + 1;
+}
+
+
+#if SCHEDULER_ISR_SAFE
+/****************************************************************************************************
+* ISR handoff ring...                                                                               *
+* A single-producer/single-consumer ring buffer. The tick ISR is the only writer of               *
+*  isr_ring_head and the slots; the main loop is the only writer of isr_ring_tail. Since each       *
+*  cursor has exactly one writer and the publication store comes last, neither side ever needs to   *
+*  mask interrupts. See the notes beside SCHEDULER_ISR_SAFE in the header for the assumptions.      *
+****************************************************************************************************/
+
+/**
+* ISR side: publish a node that has just come due. Returns false (and counts the loss)
+*  if the ring is full. The caller must not set thread_fire if this fails, or the
+*  firing would be marked pending with no way to ever get serviced.
+*/
+boolean Scheduler::isrRingPush(ScheduleItem *obj) {
+  uint16_t head  = this->isr_ring_head;
+  uint16_t nu    = (head + 1) & (SCHEDULER_ISR_RING_SIZE - 1);
+  if (nu == this->isr_ring_tail) {
+    this->isr_ring_overflows++;
+    return false;
+  }
+  this->isr_ring[head] = obj;
+  SCHEDULER_MEMORY_BARRIER();   // The slot must be visible before the cursor moves.
+  this->isr_ring_head = nu;
+  return true;
+}
+
+
+/**
+* Main-loop side: take the oldest published node, or NULL if the ring is empty.
+*  NULL slots inside the ring are firings that were revoked by node destruction
+*  (see destroyScheduleItem()); they are silently stepped over.
+*/
+ScheduleItem* Scheduler::isrRingPop() {
+  uint16_t tail  = this->isr_ring_tail;
+  while (tail != this->isr_ring_head) {
+    ScheduleItem *return_value  = this->isr_ring[tail];
+    SCHEDULER_MEMORY_BARRIER();   // The slot must be read before the cursor frees it.
+    tail = (tail + 1) & (SCHEDULER_ISR_RING_SIZE - 1);
+    this->isr_ring_tail = tail;
+    if (return_value != NULL) return return_value;
+  }
+  return NULL;
+}
+#endif  // SCHEDULER_ISR_SAFE
+
+
+/****************************************************************************************************
+* Ready-queue functions...                                                                          *
+* When a schedule expires, advanceScheduler() links it into this intrusive queue. The service       *
+*  function then pops from the head rather than scanning the whole schedule list for thread_fire,   *
+*  so an empty service pass does no per-schedule work at all.                                       *
+****************************************************************************************************/
+
+/**
+* Appends a freshly-fired schedule to the tail of its priority class's ready list.
+*  Guarded against double-insertion; a schedule that expires again before being
+*  serviced is already queued, and is simply left where it is.
+*/
+void Scheduler::readyQueuePush(ScheduleItem *obj) {
+  if (obj->thread_queued) return;
+  uint8_t p = obj->thread_priority;
+  obj->thread_queued = true;
+  obj->ready_next    = NULL;
+  if (this->ready_queue_tail[p] != NULL) this->ready_queue_tail[p]->ready_next = obj;
+  else this->ready_queue_head[p] = obj;
+  this->ready_queue_tail[p] = obj;
+}
+
+
+/**
+* Detaches and returns the next fired schedule to be serviced: the oldest item in the
+*  highest non-empty priority class. Returns NULL if nothing is waiting.
+*/
+ScheduleItem* Scheduler::readyQueuePop() {
+  for (uint8_t p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    ScheduleItem *return_value  = this->ready_queue_head[p];
+    if (return_value != NULL) {
+      this->ready_queue_head[p] = return_value->ready_next;
+      if (this->ready_queue_head[p] == NULL) this->ready_queue_tail[p] = NULL;
+      return_value->ready_next    = NULL;
+      return_value->thread_queued = false;
+      return return_value;
+    }
+  }
+  return NULL;
+}
+
+
+/**
+* Unlinks the given item from its class's ready list, wherever it sits. Called ahead of
+*  node destruction so the queue never holds a dangling reference. The scan is bounded
+*  by the number of presently-fired schedules in that class, which is typically tiny.
+*/
+void Scheduler::readyQueueRemove(ScheduleItem *obj) {
+  if (obj->thread_queued) {
+    uint8_t p = obj->thread_priority;
+    ScheduleItem *prev     = NULL;
+    ScheduleItem *current  = this->ready_queue_head[p];
+    while (current != NULL) {
+      if (current == obj) {
+        if (prev != NULL) prev->ready_next = obj->ready_next;
+        else this->ready_queue_head[p] = obj->ready_next;
+        if (this->ready_queue_tail[p] == obj) this->ready_queue_tail[p] = prev;
+        obj->ready_next    = NULL;
+        obj->thread_queued = false;
+        return;
+      }
+      prev    = current;
+      current = current->ready_next;
+    }
+  }
+}
+
+
+/**
+* Executions presently owed by the given schedule. Under SCHEDULER_ISR_SAFE the tally
+*  is split into two single-writer counters — the tick side only ever increments
+*  thread_fire, the main loop only ever moves thread_fires_taken — so neither side
+*  read-modify-writes a counter the other owns, and an expiry that lands between the
+*  dispatcher's load and store cannot be erased. What is owed is the difference,
+*  modulo the counter width: the same discipline the ring cursors use.
+*/
+static inline uint8_t fires_owed(ScheduleItem *obj) {
+#if SCHEDULER_ISR_SAFE
+  return (uint8_t) (obj->thread_fire - obj->thread_fires_taken);
+#else
+  return obj->thread_fire;
+#endif
+}
+
+
+/* Main-loop side: one owed run has been delivered. */
+static inline void fires_take(ScheduleItem *obj) {
+#if SCHEDULER_ISR_SAFE
+  obj->thread_fires_taken++;
+#else
+  obj->thread_fire--;
+#endif
+}
+
+
+/* Main-loop side: forgive everything owed so far. */
+static inline void fires_clear(ScheduleItem *obj) {
+#if SCHEDULER_ISR_SAFE
+  obj->thread_fires_taken = obj->thread_fire;
+#else
+  obj->thread_fire = 0;
+#endif
+}
+
+
+/**
+* Profiler hook, called at every expiry (and explicit fire). Stamps the fire time so
+*  the dispatcher can measure how long the firing waited for service; an expiry that
+*  finds the previous firing still unserviced is a coalesced (missed) run, and is
+*  counted instead.
+*/
+void Scheduler::stampFire(ScheduleItem *obj) {
+  if (obj->prof_data.profiling_active) {
+    uint8_t owed  = fires_owed(obj);
+    if (owed) {
+      /* Under ACCUMULATE a piled-up expiry is owed, not lost; only a saturated
+         counter (or the COALESCE policy) actually costs a run. */
+      if (!obj->thread_accumulates || (owed == 0xFF)) obj->prof_data.missed_fires++;
+    }
+    else obj->prof_data.fire_time_micros = micros();
+  }
+}
+
+
+/**
+* Marks the given schedule fired and hands it to the service side, through whichever
+*  channel the build uses (the ready-queue directly, or the ISR ring). All tick paths
+*  funnel expiries through here.
+*/
+void Scheduler::publishFire(ScheduleItem *obj) {
+  if (!this->groupPermits(obj)) return;   // The whole subsystem is muted.
+  this->stampFire(obj);
+#if SCHEDULER_ISR_SAFE
+  /* The ready-queue belongs to the main loop in this mode. Publish through the
+     ring instead, and only mark the firing if the publication succeeded. A node
+     already owing a run is already in the pipeline; an accumulating one just grows
+     its owed count, and rides the publication already in flight. Either way this
+     side only ever increments thread_fire, so a dispatch completing concurrently
+     (which advances thread_fires_taken) cannot erase the firing. */
+  uint8_t owed  = fires_owed(obj);
+  if (owed == 0) {
+    if (this->isrRingPush(obj)) obj->thread_fire++;
+  }
+  else if (obj->thread_accumulates && (owed < 0xFF)) obj->thread_fire++;
+#else
+  if (!obj->thread_fire || (obj->thread_accumulates && (obj->thread_fire < 0xFF))) obj->thread_fire++;
+  this->readyQueuePush(obj);
+#endif
+}
+
+
+/**
 * Given a pointer to the node we wish destroyed, destroy it, and maintain link integrity.
 * If the provided node is not part of the chain beginning at schedule_root_node, destroy it
 * anyway to avoid a leak, and since that is why we were called.
@@ -286,6 +887,22 @@ ScheduleItem* Scheduler::findNodeBeforeThisOne(ScheduleItem *target) {
 */
 void Scheduler::destroyScheduleItem(ScheduleItem *r_node) {
   if (r_node != NULL) {
+    this->tickPathDetach(r_node);
+#if SCHEDULER_ISR_SAFE
+    /* Disarm first so the tick ISR cannot re-publish this node, then revoke any
+       publication already sitting in the ring. The slots between tail and head are
+       quiescent (the ISR only ever writes the slot at head), so the main loop may
+       NULL them without a race. */
+    r_node->thread_enabled = false;
+    SCHEDULER_MEMORY_BARRIER();
+    for (uint16_t i = this->isr_ring_tail; i != this->isr_ring_head; i = (i + 1) & (SCHEDULER_ISR_RING_SIZE - 1)) {
+      if (this->isr_ring[i] == r_node) this->isr_ring[i] = NULL;
+    }
+#endif
+#if SCHEDULER_PID_TABLE_SIZE > 0
+    this->pidIndexRemove(r_node->pid);
+#endif
+    this->readyQueueRemove(r_node);
     ScheduleItem *current  = this->findNodeBeforeThisOne(r_node);
     if (current != NULL) {          // Did we find a place to put our "->next" ref?
       current->next = r_node->next;
@@ -293,16 +910,59 @@ void Scheduler::destroyScheduleItem(ScheduleItem *r_node) {
     else if (r_node == this->schedule_root_node) {    // Special-case, the root node is being destroyed.
       this->schedule_root_node = r_node->next;
     }
-    // We are now free to free()...
+    if (r_node == this->schedule_tail_node) this->schedule_tail_node = current;
+    // We are now free to release the storage...
     this->clearProfilingData(r_node);
-    free(r_node);
+    this->releaseScheduleItem(r_node);
+    this->notifyDeadlineChange();
+  }
+}
+
+
+/**
+* Deferred-teardown sweep. Unlinks every node the dispatcher marked dead and recycles
+*  its storage, in one forward walk: the running prev pointer makes each unlink O(1),
+*  so a burst of expired one-shots costs a single O(n) pass rather than one backward
+*  scan per node from inside the dispatch loop. Runs at the end of a service pass;
+*  nothing outside ever observes a dead node.
+*/
+void Scheduler::reapDeadSchedules() {
+  if (this->reap_count == 0) return;
+  ScheduleItem *prev     = NULL;
+  ScheduleItem *current  = this->schedule_root_node;
+  while (current != NULL) {
+    ScheduleItem *nxt  = current->next;
+    if (current->thread_dead) {
+      this->tickPathDetach(current);
+#if SCHEDULER_ISR_SAFE
+      /* The node was disarmed when it was marked, but the tick ISR may have published
+         it before that. Revoke any such entry before the storage is recycled. */
+      SCHEDULER_MEMORY_BARRIER();
+      for (uint16_t i = this->isr_ring_tail; i != this->isr_ring_head; i = (i + 1) & (SCHEDULER_ISR_RING_SIZE - 1)) {
+        if (this->isr_ring[i] == current) this->isr_ring[i] = NULL;
+      }
+#endif
+#if SCHEDULER_PID_TABLE_SIZE > 0
+      this->pidIndexRemove(current->pid);
+#endif
+      if (prev != NULL) prev->next = nxt;
+      else this->schedule_root_node = nxt;
+      if (current == this->schedule_tail_node) this->schedule_tail_node = prev;
+      this->clearProfilingData(current);
+      this->releaseScheduleItem(current);
+    }
+    else prev = current;
+    current = nxt;
   }
+  this->reap_count = 0;
+  this->notifyDeadlineChange();
 }
 
 
+#if SCHEDULER_POOL_SIZE == 0
 /**
 *  When we assign a new PID, call this function to get one. Since we don't want
-*    to collide with one that already exists, or get the zero value. 
+*    to collide with one that already exists, or get the zero value.
 */
 uint32_t Scheduler::get_valid_new_pid() {
     uint32_t return_value = this->next_pid++;
@@ -320,6 +980,18 @@ uint32_t Scheduler::get_valid_new_pid() {
 uint32_t Scheduler::peekNextPID() {
   return this->next_pid;
 }
+#else
+/**
+*  With the static pool, PIDs come from slots rather than a counter, so the best
+*    we can do is report what the next acquisition would be issued. Returns 0 if
+*    the pool is exhausted.
+*/
+uint32_t Scheduler::peekNextPID() {
+  if (!pools_initialized) initialize_pools();
+  int16_t slot = pool_first_free();
+  return (slot >= 0) ? pool_pid_for_slot(slot) : 0;
+}
+#endif  // SCHEDULER_POOL_SIZE == 0
 
 
 /**
@@ -329,23 +1001,52 @@ uint32_t Scheduler::peekNextPID() {
 *  Returns the newly-created PID on success, or 0 on failure.
 */
 uint32_t Scheduler::createSchedule(uint32_t sch_period, int16_t recurrence, boolean ac, FunctionPointer sch_callback) {
-  uint32_t return_value  = 0;
-  if (sch_period > 1) {
-    if (sch_callback != NULL) {
-      ScheduleItem *nu_sched = (ScheduleItem *) malloc(sizeof(ScheduleItem));
-      if (nu_sched != NULL) {  // Did we actually malloc() successfully?
-        memset(nu_sched, 0x00, sizeof(ScheduleItem));
-        nu_sched->pid  = this->get_valid_new_pid();
-        nu_sched->thread_enabled      = true;    // Note: Enables immediately.
-        nu_sched->thread_fire         = false;
-        nu_sched->thread_recurs       = recurrence;
-        nu_sched->thread_period       = sch_period;
-        nu_sched->next                = NULL;
-        nu_sched->thread_time_to_wait = sch_period;
-        nu_sched->autoclear           = ac;
-        nu_sched->schedule_callback   = sch_callback;
-        return_value  = nu_sched->pid;
-        this->insertScheduleItemAtEnd(nu_sched);
+  if (sch_callback == NULL) return 0;
+  return this->createScheduleRaw(sch_period, recurrence, ac, sch_callback, NULL, NULL, SCHEDULER_PHASE_DEFAULT);
+}
+
+
+/**
+* As above, but the schedule's service function takes the given argument at each dispatch.
+*/
+uint32_t Scheduler::createSchedule(uint32_t sch_period, int16_t recurrence, boolean ac, ArgFunctionPointer sch_callback, void* arg) {
+  if (sch_callback == NULL) return 0;
+  return this->createScheduleRaw(sch_period, recurrence, ac, NULL, sch_callback, arg, SCHEDULER_PHASE_DEFAULT);
+}
+
+
+/**
+* As above, with an explicit phase. The phase becomes the initial countdown, so the
+*  first firing lands (phase + 1) ticks from the call; the period takes over from there.
+*/
+uint32_t Scheduler::createSchedule(uint32_t sch_period, int16_t recurrence, boolean ac, FunctionPointer sch_callback, uint32_t phase) {
+  if (sch_callback == NULL) return 0;
+  return this->createScheduleRaw(sch_period, recurrence, ac, sch_callback, NULL, NULL, phase);
+}
+
+
+uint32_t Scheduler::createSchedule(uint32_t sch_period, int16_t recurrence, boolean ac, ArgFunctionPointer sch_callback, void* arg, uint32_t phase) {
+  if (sch_callback == NULL) return 0;
+  return this->createScheduleRaw(sch_period, recurrence, ac, NULL, sch_callback, arg, phase);
+}
+
+
+/**
+* Bulk creation from a const table. With the cached tail pointer each row links in O(1),
+*  so the whole table builds in a single pass regardless of how many schedules are
+*  already defined. Returns how many rows were actually created; a short count means
+*  node storage ran out. If pids is non-NULL, the new PID (or zero) is recorded per row.
+*/
+uint16_t Scheduler::createSchedules(const ScheduleDef* defs, uint16_t count, uint32_t* pids) {
+  uint16_t return_value  = 0;
+  if (defs != NULL) {
+    for (uint16_t i = 0; i < count; i++) {
+      uint32_t nu_pid  = this->createScheduleRaw(defs[i].period, defs[i].recurrence, defs[i].autoclear, defs[i].callback, NULL, NULL, SCHEDULER_PHASE_DEFAULT);
+      if (pids != NULL) pids[i] = nu_pid;
+      if (nu_pid != 0) {
+        if (defs[i].group != 0) this->setScheduleGroup(nu_pid, defs[i].group);
+        if (defs[i].policy != SCHEDULER_FIRES_COALESCE) this->setFirePolicy(nu_pid, defs[i].policy);
+        return_value++;
       }
     }
   }
@@ -354,22 +1055,91 @@ uint32_t Scheduler::createSchedule(uint32_t sch_period, int16_t recurrence, bool
 
 
 /**
-* Call this function to alter a given schedule. Set with the given period, a given number of times, with a given function call.
-*  Returns true on success or false if the given PID is not found, or there is a problem with the parameters.
-*
-* Will not set the schedule active, but will clear any pending executions for this schedule, as well as reset the timer for it.
+* Common node-construction path behind the createSchedule() flavors. Exactly one of
+*  sch_callback/arg_cb is non-NULL by the time we are called; phase is either an
+*  explicit placement or SCHEDULER_PHASE_DEFAULT.
 */
-boolean Scheduler::alterSchedule(ScheduleItem *obj, uint32_t sch_period, int16_t recurrence, boolean ac, FunctionPointer sch_callback) {
-  boolean return_value  = false;
+uint32_t Scheduler::createScheduleRaw(uint32_t sch_period, int16_t recurrence, boolean ac, FunctionPointer sch_callback, ArgFunctionPointer arg_cb, void* arg, uint32_t phase) {
+  uint32_t return_value  = 0;
   if (sch_period > 1) {
-    if (sch_callback != NULL) {
-      if (obj != NULL) {
-        obj->thread_fire         = false;
-        obj->thread_recurs       = recurrence;
+    uint32_t initial_ttw  = sch_period;
+    if (phase != SCHEDULER_PHASE_DEFAULT) {
+      initial_ttw = phase % (sch_period + 1);
+    }
+#if SCHEDULER_AUTO_PHASE
+    else {
+      /* Spread placement: stagger this schedule one tick behind each schedule that
+         already shares its period, wrapping once the period's ticks are all taken. */
+      uint32_t same_period  = 0;
+      ScheduleItem *current = this->schedule_root_node;
+      while (current != NULL) {
+        if (current->thread_period == sch_period) same_period++;
+        current = current->next;
+      }
+      initial_ttw = sch_period - (same_period % (sch_period + 1));
+    }
+#endif
+    ScheduleItem *nu_sched = this->acquireScheduleItem();
+    if (nu_sched != NULL) {  // Did we actually get the storage?
+#if SCHEDULER_POOL_SIZE > 0
+      nu_sched->pid  = pool_pid_for_slot((int16_t) (nu_sched - item_pool));
+#else
+      nu_sched->pid  = this->get_valid_new_pid();
+#endif
+      nu_sched->thread_enabled      = true;    // Note: Enables immediately.
+      nu_sched->thread_fire         = 0;
+      nu_sched->thread_accumulates  = false;   // Coalesce, until told otherwise.
+      nu_sched->thread_recurs       = recurrence;
+      nu_sched->thread_period       = sch_period;
+      nu_sched->next                = NULL;
+      nu_sched->thread_time_to_wait = initial_ttw;
+      nu_sched->autoclear           = ac;
+      nu_sched->schedule_callback   = sch_callback;
+      nu_sched->arg_callback        = arg_cb;
+      nu_sched->callback_arg        = arg;
+      nu_sched->thread_priority     = SCHEDULER_NUM_PRIORITIES - 1;   // Lowest class, until promoted.
+      return_value  = nu_sched->pid;
+      this->insertScheduleItemAtEnd(nu_sched);
+#if SCHEDULER_PID_TABLE_SIZE > 0
+      this->pidIndexInsert(nu_sched);
+#endif
+      this->tickPathAttach(nu_sched, nu_sched->thread_time_to_wait);
+#if SCHEDULER_POOL_SIZE > 0
+      /* Taking ownership is what makes the slot visible to the slab sweep, so it
+         happens last, once the node is fully formed. */
+#if SCHEDULER_ISR_SAFE
+      SCHEDULER_MEMORY_BARRIER();
+#endif
+      nu_sched->owner  = (void*) this;
+#endif
+      this->notifyDeadlineChange();
+    }
+  }
+  return return_value;
+}
+
+
+/**
+* Call this function to alter a given schedule. Set with the given period, a given number of times, with a given function call.
+*  Returns true on success or false if the given PID is not found, or there is a problem with the parameters.
+*
+* Will not set the schedule active, but will clear any pending executions for this schedule, as well as reset the timer for it.
+*/
+boolean Scheduler::alterSchedule(ScheduleItem *obj, uint32_t sch_period, int16_t recurrence, boolean ac, FunctionPointer sch_callback) {
+  boolean return_value  = false;
+  if (sch_period > 1) {
+    if (sch_callback != NULL) {
+      if (obj != NULL) {
+        fires_clear(obj);
+        obj->thread_recurs       = recurrence;
         obj->thread_period       = sch_period;
         obj->thread_time_to_wait = sch_period;
         obj->autoclear           = ac;
         obj->schedule_callback   = sch_callback;
+        obj->arg_callback        = NULL;
+        obj->callback_arg        = NULL;
+        if (obj->thread_enabled) this->tickPathAttach(obj, obj->thread_time_to_wait);
+        this->notifyDeadlineChange();
         return_value  = true;
       }
     }
@@ -397,6 +1167,22 @@ boolean Scheduler::alterSchedule(uint32_t schedule_index, FunctionPointer sch_ca
     ScheduleItem *nu_sched  = findNodeByPID(schedule_index);
     if (nu_sched != NULL) {
       nu_sched->schedule_callback   = sch_callback;
+      nu_sched->arg_callback        = NULL;
+      nu_sched->callback_arg        = NULL;
+      return_value  = true;
+    }
+  }
+  return return_value;
+}
+
+boolean Scheduler::alterSchedule(uint32_t schedule_index, ArgFunctionPointer sch_callback, void* arg) {
+  boolean return_value  = false;
+  if (sch_callback != NULL) {
+    ScheduleItem *nu_sched  = findNodeByPID(schedule_index);
+    if (nu_sched != NULL) {
+      nu_sched->schedule_callback   = NULL;
+      nu_sched->arg_callback        = sch_callback;
+      nu_sched->callback_arg        = arg;
       return_value  = true;
     }
   }
@@ -408,20 +1194,48 @@ boolean Scheduler::alterSchedulePeriod(uint32_t schedule_index, uint32_t sch_per
   if (sch_period > 1) {
     ScheduleItem *nu_sched  = findNodeByPID(schedule_index);
     if (nu_sched != NULL) {
-      nu_sched->thread_fire         = false;
+      fires_clear(nu_sched);
       nu_sched->thread_period       = sch_period;
       nu_sched->thread_time_to_wait = sch_period;
+      if (nu_sched->thread_enabled) this->tickPathAttach(nu_sched, nu_sched->thread_time_to_wait);
+      this->notifyDeadlineChange();
       return_value  = true;
     }
   }
   return return_value;
 }
 
+#if SCHEDULER_FIXED_POINT
+/**
+* Puts the schedule in drift-free mode with the given 16.16 fixed-point firing interval,
+*  or (given zero) returns it to integer-period mode. Resets the countdown and the
+*  fractional remainder, and clears any pending firing, just as alterSchedulePeriod()
+*  does. Intervals shorter than two whole ticks are refused.
+*/
+boolean Scheduler::alterSchedulePeriodFixed(uint32_t schedule_index, uint32_t period_fp_ticks) {
+  boolean return_value  = false;
+  if ((period_fp_ticks == 0) || (period_fp_ticks >= 0x00020000)) {
+    ScheduleItem *nu_sched  = findNodeByPID(schedule_index);
+    if (nu_sched != NULL) {
+      fires_clear(nu_sched);
+      nu_sched->thread_period_fp    = period_fp_ticks;
+      nu_sched->fp_accumulator      = 0;
+      nu_sched->thread_time_to_wait = (period_fp_ticks != 0) ? ((period_fp_ticks >> 16) - 1) : nu_sched->thread_period;
+      if (nu_sched->thread_enabled) this->tickPathAttach(nu_sched, nu_sched->thread_time_to_wait);
+      this->notifyDeadlineChange();
+      return_value  = true;
+    }
+  }
+  return return_value;
+}
+#endif  // SCHEDULER_FIXED_POINT
+
+
 boolean Scheduler::alterScheduleRecurrence(uint32_t schedule_index, int16_t recurrence) {
   boolean return_value  = false;
   ScheduleItem *nu_sched  = findNodeByPID(schedule_index);
   if (nu_sched != NULL) {
-    nu_sched->thread_fire         = false;
+    fires_clear(nu_sched);
     nu_sched->thread_recurs       = recurrence;
     return_value  = true;
   }
@@ -429,6 +1243,55 @@ boolean Scheduler::alterScheduleRecurrence(uint32_t schedule_index, int16_t recu
 }
 
 
+/**
+* Moves the schedule into the given priority class (0 is highest). If the schedule has
+*  already fired and is waiting for service, it is re-queued into its new class.
+*  Returns true on success, false on a bad PID or class.
+*/
+boolean Scheduler::setSchedulePriority(uint32_t g_pid, uint8_t priority) {
+  boolean return_value  = false;
+  if (priority < SCHEDULER_NUM_PRIORITIES) {
+    ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+    if (nu_sched != NULL) {
+      this->readyQueueRemove(nu_sched);
+      nu_sched->thread_priority = priority;
+      if (fires_owed(nu_sched)) this->readyQueuePush(nu_sched);
+      return_value  = true;
+    }
+  }
+  return return_value;
+}
+
+
+/**
+* Declares a runtime budget for the given schedule, enabling profiling for it if it
+*  was not already profiled (the budget is checked against the measured runtime, so
+*  there is no enforcement without measurement). A budget of zero ends enforcement
+*  but leaves profiling running. Returns false on a bad PID.
+*/
+boolean Scheduler::setExecutionBudget(uint32_t g_pid, uint32_t micros_budget) {
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) {
+    this->beginProfiling(nu_sched);
+    nu_sched->prof_data.budget_micros  = micros_budget;
+    nu_sched->prof_data.budget_strikes = 0;
+    return true;
+  }
+  return false;
+}
+
+
+/**
+* How many times has the given schedule run over its declared budget?
+*  Returns zero for an unknown PID or an unprofiled schedule.
+*/
+uint32_t Scheduler::getBudgetOverruns(uint32_t g_pid) {
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) return nu_sched->prof_data.budget_overruns;
+  return 0;
+}
+
+
 /**
 * Returns true if...
 * A) The schedule exists
@@ -448,6 +1311,186 @@ boolean Scheduler::willRunAgain(uint32_t g_pid) {
 }
 
 
+#if SCHEDULER_ONESHOT_SLOTS > 0
+/**
+* Arms a one-shot: cb runs once, on the first tick after delay_ticks have elapsed.
+*  The free-slot scan starts where the last one left off, so under steady churn it
+*  finds a slot in one or two probes. Returns a cancellation handle, or zero if all
+*  slots are armed.
+*/
+uint32_t Scheduler::runLater(FunctionPointer cb, uint32_t delay_ticks) {
+  if (cb == NULL) return 0;
+  for (int n = 0; n < SCHEDULER_ONESHOT_SLOTS; n++) {
+    uint8_t i  = this->oneshot_cursor;
+    this->oneshot_cursor = (this->oneshot_cursor + 1) % SCHEDULER_ONESHOT_SLOTS;
+    if (this->oneshot_cb[i] == NULL) {
+      this->oneshot_ttw[i]   = delay_ticks;
+      this->oneshot_fired[i] = false;
+#if SCHEDULER_ISR_SAFE
+      // The non-NULL callback is what makes the slot live to the tick ISR.
+      SCHEDULER_MEMORY_BARRIER();
+#endif
+      this->oneshot_cb[i]    = cb;
+      return ((uint32_t) this->oneshot_gen[i] << 16) | (i + 1);
+    }
+  }
+  return 0;
+}
+
+
+/**
+* Disarms the one-shot behind the given handle. O(1). Returns false if the handle is
+*  stale (the one-shot already ran or was cancelled, and the slot possibly re-armed).
+*/
+boolean Scheduler::cancelOneShot(uint32_t handle) {
+  uint16_t slot  = (handle & 0xFFFF);
+  if ((slot == 0) || (slot > SCHEDULER_ONESHOT_SLOTS)) return false;
+  slot--;
+  if (this->oneshot_gen[slot] != (uint8_t)(handle >> 16)) return false;
+  if (this->oneshot_cb[slot] == NULL) return false;
+  this->oneshot_cb[slot]    = NULL;   // A single store; safe against a concurrent tick.
+  this->oneshot_fired[slot] = false;
+  this->oneshot_gen[slot]++;
+  return true;
+}
+#endif  // SCHEDULER_ONESHOT_SLOTS > 0
+
+
+/**
+* Marks the given item fired and queues it for service. This is the main-loop-side
+*  counterpart to publishFire(): the ready-queue belongs to this side in every build
+*  configuration, so it may be appended directly, even from within a running callback.
+*/
+void Scheduler::fireNow(ScheduleItem *obj) {
+  if (!this->groupPermits(obj)) return;   // The whole subsystem is muted.
+  this->stampFire(obj);
+  uint8_t owed  = fires_owed(obj);
+  if ((owed == 0) || (obj->thread_accumulates && (owed < 0xFF))) {
+#if SCHEDULER_ISR_SAFE
+    /* Publication from the main loop walks its own counter backward rather than
+       touching the tick side's tally: the owed count grows by one either way, and
+       each counter keeps its single writer. */
+    obj->thread_fires_taken--;
+#else
+    obj->thread_fire++;
+#endif
+  }
+  this->readyQueuePush(obj);
+}
+
+
+/**
+* Names a successor schedule to be fired each time the given schedule's callback
+*  completes. Pass zero to sever the chain. Returns false on an unknown PID; the
+*  successor is resolved at completion time, so it need not exist yet (an unknown
+*  successor simply fires nothing).
+*/
+boolean Scheduler::chainSchedule(uint32_t g_pid, uint32_t successor_pid) {
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) {
+    nu_sched->chain_pid = successor_pid;
+    return true;
+  }
+  return false;
+}
+
+
+/**
+* Fires the given schedule immediately, without waiting for its countdown (which is
+*  left undisturbed). Works on disabled schedules too: a pipeline's later stages are
+*  typically left disabled so that only their predecessor (or this call) runs them.
+*  Legal from inside a callback; the firing is serviced later in the same pass when
+*  the service budget allows.
+*/
+boolean Scheduler::fireSchedule(uint32_t g_pid) {
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) {
+    this->fireNow(nu_sched);
+    return true;
+  }
+  return false;
+}
+
+
+/**
+* Does the item's group, if it has one, permit it to run? Ungrouped items always may.
+*/
+boolean Scheduler::groupPermits(ScheduleItem *obj) {
+  if (obj->thread_group == 0) return true;
+  return (this->group_enable_mask >> (obj->thread_group - 1)) & 1;
+}
+
+
+/**
+* Sets the schedule's missed-event policy. Moving to COALESCE forgives any backlog
+*  beyond the single run already owed. Returns false on an unknown PID or a policy
+*  value that names neither policy.
+*/
+boolean Scheduler::setFirePolicy(uint32_t g_pid, uint8_t policy) {
+  if (policy > SCHEDULER_FIRES_ACCUMULATE) return false;
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) {
+    nu_sched->thread_accumulates = (policy == SCHEDULER_FIRES_ACCUMULATE);
+    if (!nu_sched->thread_accumulates) {
+      uint8_t owed  = fires_owed(nu_sched);
+#if SCHEDULER_ISR_SAFE
+      if (owed > 1) nu_sched->thread_fires_taken += (owed - 1);
+#else
+      if (owed > 1) nu_sched->thread_fire = 1;
+#endif
+    }
+    return true;
+  }
+  return false;
+}
+
+
+/**
+* Files the given schedule into a subsystem group (1..32), or unfiles it (group zero).
+*  Returns false on an unknown PID or an out-of-range group.
+*/
+boolean Scheduler::setScheduleGroup(uint32_t g_pid, uint8_t group) {
+  if (group > 32) return false;
+  ScheduleItem *nu_sched  = findNodeByPID(g_pid);
+  if (nu_sched != NULL) {
+    nu_sched->thread_group = group;
+    return true;
+  }
+  return false;
+}
+
+
+/**
+* Unmutes every schedule in the given group by setting its mask bit.
+*/
+boolean Scheduler::enableGroup(uint8_t group) {
+  if ((group == 0) || (group > 32)) return false;
+  this->group_enable_mask |= ((uint32_t) 1 << (group - 1));
+  return true;
+}
+
+
+/**
+* Mutes every schedule in the given group by clearing its mask bit. O(1): the
+*  schedules themselves are untouched and keep their cadence, but their firings are
+*  suppressed until the group is re-enabled.
+*/
+boolean Scheduler::disableGroup(uint8_t group) {
+  if ((group == 0) || (group > 32)) return false;
+  this->group_enable_mask &= ~((uint32_t) 1 << (group - 1));
+  return true;
+}
+
+
+/**
+* Is the given group presently unmuted? Group zero (ungrouped) always is.
+*/
+boolean Scheduler::groupEnabled(uint8_t group) {
+  if ((group == 0) || (group > 32)) return (group == 0);
+  return (this->group_enable_mask >> (group - 1)) & 1;
+}
+
+
 boolean Scheduler::scheduleEnabled(uint32_t g_pid) {
   ScheduleItem *nu_sched  = findNodeByPID(g_pid);
   if (nu_sched != NULL) {
@@ -464,7 +1507,11 @@ boolean Scheduler::scheduleEnabled(uint32_t g_pid) {
 boolean Scheduler::enableSchedule(uint32_t g_pid) {
   ScheduleItem *nu_sched  = findNodeByPID(g_pid);
   if (nu_sched != NULL) {
-    nu_sched->thread_enabled = true;
+    if (!nu_sched->thread_enabled) {
+      nu_sched->thread_enabled = true;
+      this->tickPathAttach(nu_sched, nu_sched->thread_time_to_wait);
+      this->notifyDeadlineChange();
+    }
     return true;
   }
   return false;
@@ -475,6 +1522,8 @@ boolean Scheduler::delaySchedule(ScheduleItem *obj, uint32_t by_ms) {
   if (obj != NULL) {
     obj->thread_time_to_wait = by_ms;
     obj->thread_enabled = true;
+    this->tickPathAttach(obj, by_ms);
+    this->notifyDeadlineChange();
     return true;
   }
   return false;
@@ -507,22 +1556,371 @@ boolean Scheduler::delaySchedule(uint32_t g_pid) {
 }
 
 
+/**
+* Aligns the given schedule's next firing with buddy's: both countdowns hit zero on the
+*  same tick, so tasks that share a peripheral wake-up pay for it once. Does not enable
+*  or disable anything, and fails if either PID is unknown or buddy is disabled (a
+*  disabled buddy has no next firing to align with).
+*/
+boolean Scheduler::coalesceSchedule(uint32_t g_pid, uint32_t buddy_pid) {
+  boolean return_value  = false;
+  ScheduleItem *obj    = findNodeByPID(g_pid);
+  ScheduleItem *buddy  = findNodeByPID(buddy_pid);
+  if ((obj != NULL) && (buddy != NULL) && (obj != buddy)) {
+    if (buddy->thread_enabled) {
+      uint32_t remaining  = this->ticksRemaining(buddy);
+      obj->thread_time_to_wait = remaining - 1;
+      if (obj->thread_enabled) {
+        this->tickPathAttach(obj, obj->thread_time_to_wait);
+        this->notifyDeadlineChange();
+      }
+      return_value  = true;
+    }
+  }
+  return return_value;
+}
+
+
+
+/**
+* Computes the countdown for the given schedule's next firing. In the integer case this
+*  is just the period. With SCHEDULER_FIXED_POINT, a schedule carrying a fixed-point
+*  interval accumulates its fractional ticks from firing to firing, so each reload is
+*  computed from the running remainder and the long-run rate comes out exact.
+*/
+uint32_t Scheduler::reloadTTW(ScheduleItem *obj) {
+#if SCHEDULER_FIXED_POINT
+  if (obj->thread_period_fp != 0) {
+    uint32_t frac  = (uint32_t) obj->fp_accumulator + (obj->thread_period_fp & 0xFFFF);
+    obj->fp_accumulator = (uint16_t) frac;
+    /* The countdown fires on the tick after it reaches zero, hence the -1. */
+    return ((obj->thread_period_fp >> 16) + (frac >> 16)) - 1;
+  }
+#endif
+  return obj->thread_period;
+}
+
+
+/**
+* How many ticks from now will the soonest enabled schedule fire?
+*  Returns zero if a firing is already awaiting service, and SCHEDULER_TICKS_INDEFINITE
+*  if no enabled schedule exists. This is the query behind tickless operation: program a
+*  hardware compare-match this many ticks out, sleep, and make up the gap with
+*  advanceScheduler(nu_ticks) on wake.
+*/
+uint32_t Scheduler::ticksUntilNextFire() {
+  for (int p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    if (this->ready_queue_head[p] != NULL) return 0;
+  }
+#if SCHEDULER_ISR_SAFE
+  if (this->isr_ring_head != this->isr_ring_tail) return 0;
+#endif
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  uint32_t oneshot_soonest = SCHEDULER_TICKS_INDEFINITE;
+  for (int i = 0; i < SCHEDULER_ONESHOT_SLOTS; i++) {
+    if (this->oneshot_cb[i] != NULL) {
+      if (this->oneshot_fired[i]) return 0;
+      if ((this->oneshot_ttw[i] + 1) < oneshot_soonest) oneshot_soonest = this->oneshot_ttw[i] + 1;
+    }
+  }
+#endif
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  uint32_t soonest = oneshot_soonest;
+#else
+  uint32_t soonest = SCHEDULER_TICKS_INDEFINITE;
+#endif
+#if SCHEDULER_DELTA_QUEUE
+  /* The delta chain is deadline-sorted, so the head's delta is the answer. */
+  if ((this->delta_root != NULL) && (this->delta_root->delta_ttw < soonest)) soonest = this->delta_root->delta_ttw;
+  return soonest;
+#else
+  ScheduleItem *current  = this->schedule_root_node;
+  while (current != NULL) {
+    if (current->thread_enabled) {
+#if SCHEDULER_WHEEL_BUCKETS > 0
+      if (current->wheel_bucket >= 0) {
+        /* Distance to the bucket around the wheel face, plus any full revolutions. */
+        uint32_t d = (uint32_t)(current->wheel_bucket - this->wheel_tick) & (SCHEDULER_WHEEL_BUCKETS - 1);
+        if (d == 0) d = SCHEDULER_WHEEL_BUCKETS;
+        d += current->wheel_rounds * SCHEDULER_WHEEL_BUCKETS;
+        if (d < soonest) soonest = d;
+      }
+#else
+      /* The countdown fires on the tick after it reaches zero. */
+      if ((current->thread_time_to_wait + 1) < soonest) soonest = current->thread_time_to_wait + 1;
+#endif
+    }
+    current = current->next;
+  }
+  return soonest;
+#endif  // SCHEDULER_DELTA_QUEUE
+}
+
+
+/**
+* Registers (or, given NULL, unregisters) a function to be told the new
+*  ticksUntilNextFire() whenever a control-plane call moves the soonest deadline.
+*/
+void Scheduler::setDeadlineCallback(DeadlineFunctionPointer cb) {
+  this->deadline_callback = cb;
+}
+
+
+#if SCHEDULER_WATCHDOG_TICKS > 0
+/**
+* Registers (or, given NULL, unregisters) the stuck-task hook. Invoked from tick
+*  context, once per incident. See the notes at SCHEDULER_WATCHDOG_TICKS.
+*/
+void Scheduler::setWatchdogCallback(WatchdogFunctionPointer cb) {
+  this->watchdog_callback = cb;
+}
+#endif  // SCHEDULER_WATCHDOG_TICKS > 0
+
+
+/**
+* Called after any mutation that can move the soonest deadline.
+*/
+void Scheduler::notifyDeadlineChange() {
+  if (this->deadline_callback != NULL) this->deadline_callback(this->ticksUntilNextFire());
+}
+
 
 /**
 * Call this function to push the schedules forward.
 */
 void Scheduler::advanceScheduler() {
+#if SCHEDULER_WATCHDOG_TICKS > 0
+  /* Stuck-task supervision: if the dispatch that was in flight last tick is still the
+     one in flight now, it has burned another whole tick. When no callback is running
+     (the usual case), this is a single compare. */
+  if (this->currently_executing != 0) {
+    if (this->watchdog_mark_seq == this->dispatch_seq) {
+      if (++this->watchdog_ticks_in == (SCHEDULER_WATCHDOG_TICKS + 1)) {
+        this->watchdog_stuck_pid = this->currently_executing;
+        this->watchdog_stuck_events++;
+        if (this->watchdog_callback != NULL) this->watchdog_callback(this->currently_executing, this->watchdog_ticks_in);
+      }
+    }
+    else {
+      this->watchdog_mark_seq = this->dispatch_seq;
+      this->watchdog_ticks_in = 1;
+    }
+  }
+#endif
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  /* Timing-wheel path: only the bucket that corresponds to this tick is examined,
+     so tick cost is proportional to the number of items coming due, not the number
+     of schedules defined. Items seen before their time simply burn a round. */
+  this->wheel_tick++;
+  ScheduleItem *current  = this->wheel_buckets[this->wheel_tick & (SCHEDULER_WHEEL_BUCKETS - 1)];
+  ScheduleItem *temp;
+  while (current != NULL) {
+    temp = current->wheel_next;
+    if (current->wheel_rounds > 0) {
+      current->wheel_rounds--;
+    }
+    else {
+      this->wheelRemove(current);
+      if (current->thread_enabled) {
+        current->thread_time_to_wait = this->reloadTTW(current);
+        this->publishFire(current);
+        this->wheelInsert(current, current->thread_time_to_wait);
+      }
+    }
+    current = temp;
+  }
+#elif SCHEDULER_DELTA_QUEUE
+  /* Delta-queue path: only the head of the deadline-sorted chain is decremented.
+     When it reaches zero, it and any same-deadline items behind it come due. */
+  if (this->delta_root != NULL) {
+    if (this->delta_root->delta_ttw > 0) this->delta_root->delta_ttw--;
+    while ((this->delta_root != NULL) && (this->delta_root->delta_ttw == 0)) {
+      ScheduleItem *current  = this->delta_root;
+      this->delta_root       = current->delta_next;
+      current->delta_next    = NULL;
+      current->delta_linked  = false;
+      if (current->thread_enabled) {
+        current->thread_time_to_wait = this->reloadTTW(current);
+        this->publishFire(current);
+        this->deltaInsert(current, current->thread_time_to_wait);
+      }
+    }
+  }
+#elif SCHEDULER_POOL_SIZE > 0
+  /* Linear path over the static pool: the items live in one contiguous slab, so walk
+     it in slot order. Sequential access, no pointer chasing, and the hot fields of
+     consecutive items share cache lines. Slots owned by other Scheduler instances
+     (or free) are skipped. */
+  for (int16_t i = 0; i < SCHEDULER_POOL_SIZE; i++) {
+    ScheduleItem *current  = &item_pool[i];
+    if (current->owner != (void*) this) continue;
+    if (current->thread_enabled) {
+      if (current->thread_time_to_wait > 0) current->thread_time_to_wait--;
+      else {
+        current->thread_time_to_wait = this->reloadTTW(current);
+        this->publishFire(current);
+      }
+    }
+  }
+#else
   ScheduleItem *current  = this->schedule_root_node;
   while (current != NULL) {
     if (current->thread_enabled) {
       if (current->thread_time_to_wait > 0) current->thread_time_to_wait--;
       else {
-        current->thread_fire = true;
-        current->thread_time_to_wait = current->thread_period;
+        current->thread_time_to_wait = this->reloadTTW(current);
+        this->publishFire(current);
       }
     }
     current = current->next;
   }
+#endif  // tick-path selection
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  /* One-shot slots tick as a flat scan, whatever strategy the schedules use. */
+  for (int i = 0; i < SCHEDULER_ONESHOT_SLOTS; i++) {
+    if ((this->oneshot_cb[i] != NULL) && !this->oneshot_fired[i]) {
+      if (this->oneshot_ttw[i] > 0) this->oneshot_ttw[i]--;
+      else this->oneshot_fired[i] = true;
+    }
+  }
+#endif
+}
+
+
+/**
+* Catch-up variant: pushes every schedule forward by nu_ticks in one pass.
+*  In the default linear mode, each schedule's new countdown is computed arithmetically,
+*  so a 500-tick catch-up costs a single walk of the list. Firings that elapsed more
+*  than once during the gap coalesce into one pending execution; the recurrence count
+*  is likewise charged only once.
+*  The wheel and delta paths already do per-tick work proportional only to what is due,
+*  so for those this simply iterates the tick.
+*/
+void Scheduler::advanceScheduler(uint32_t nu_ticks) {
+#if (SCHEDULER_WATCHDOG_TICKS > 0) && !((SCHEDULER_WHEEL_BUCKETS > 0) || SCHEDULER_DELTA_QUEUE)
+  /* Supervision, batch form: the whole gap counts against whatever dispatch is in
+     flight. The wheel and delta builds iterate the single tick below and are
+     covered there. */
+  if ((this->currently_executing != 0) && (nu_ticks != 0)) {
+    if (this->watchdog_mark_seq == this->dispatch_seq) {
+      boolean was_under  = (this->watchdog_ticks_in <= SCHEDULER_WATCHDOG_TICKS);
+      this->watchdog_ticks_in += nu_ticks;
+      if (was_under && (this->watchdog_ticks_in > SCHEDULER_WATCHDOG_TICKS)) {
+        this->watchdog_stuck_pid = this->currently_executing;
+        this->watchdog_stuck_events++;
+        if (this->watchdog_callback != NULL) this->watchdog_callback(this->currently_executing, this->watchdog_ticks_in);
+      }
+    }
+    else {
+      this->watchdog_mark_seq = this->dispatch_seq;
+      this->watchdog_ticks_in = nu_ticks;
+    }
+  }
+#endif
+#if (SCHEDULER_WHEEL_BUCKETS > 0) || SCHEDULER_DELTA_QUEUE
+  while (nu_ticks > 0) {
+    this->advanceScheduler();
+    nu_ticks--;
+  }
+#elif SCHEDULER_POOL_SIZE > 0
+  if (nu_ticks == 0) return;
+  /* Same slab sweep as the single-tick case above. */
+  for (int16_t i = 0; i < SCHEDULER_POOL_SIZE; i++) {
+    ScheduleItem *current  = &item_pool[i];
+    if (current->owner != (void*) this) continue;
+    if (current->thread_enabled) {
+      if (current->thread_time_to_wait >= nu_ticks) {
+        current->thread_time_to_wait -= nu_ticks;
+      }
+      else {
+        uint32_t past_first  = nu_ticks - (current->thread_time_to_wait + 1);
+        uint32_t fires       = 1;
+#if SCHEDULER_FIXED_POINT
+        if (current->thread_period_fp != 0) {
+          /* Fractional intervals vary reload-to-reload, so no closed-form modulo:
+             step the accumulator through the firings that fell inside the gap. */
+          uint32_t interval  = this->reloadTTW(current) + 1;
+          while (interval <= past_first) {
+            past_first -= interval;
+            interval    = this->reloadTTW(current) + 1;
+            fires++;
+          }
+          current->thread_time_to_wait = (interval - past_first) - 1;
+        }
+        else {
+          fires += past_first / (current->thread_period + 1);
+          current->thread_time_to_wait = current->thread_period - (past_first % (current->thread_period + 1));
+        }
+#else
+        fires += past_first / (current->thread_period + 1);
+        current->thread_time_to_wait = current->thread_period - (past_first % (current->thread_period + 1));
+#endif
+        this->publishFire(current);
+        /* An accumulating schedule is owed every firing the gap swallowed, exactly as
+           if the ticks had been delivered one at a time. The check on the owed count
+           keeps a muted (or otherwise unpublished) firing from accruing debt. */
+        if ((fires > 1) && current->thread_accumulates && fires_owed(current)) {
+          uint32_t room  = 0xFF - fires_owed(current);
+          current->thread_fire += (uint8_t) (((fires - 1) > room) ? room : (fires - 1));
+        }
+      }
+    }
+  }
+#else
+  if (nu_ticks == 0) return;
+  ScheduleItem *current  = this->schedule_root_node;
+  while (current != NULL) {
+    if (current->thread_enabled) {
+      if (current->thread_time_to_wait >= nu_ticks) {
+        current->thread_time_to_wait -= nu_ticks;
+      }
+      else {
+        /* At least one firing fell inside the gap. The countdown fires on the tick
+           after it reaches zero, so the schedule's interval is (period + 1) ticks and
+           the first firing consumed (thread_time_to_wait + 1) of them. */
+        uint32_t past_first  = nu_ticks - (current->thread_time_to_wait + 1);
+        uint32_t fires       = 1;
+#if SCHEDULER_FIXED_POINT
+        if (current->thread_period_fp != 0) {
+          /* Fractional intervals vary reload-to-reload, so no closed-form modulo:
+             step the accumulator through the firings that fell inside the gap. */
+          uint32_t interval  = this->reloadTTW(current) + 1;
+          while (interval <= past_first) {
+            past_first -= interval;
+            interval    = this->reloadTTW(current) + 1;
+            fires++;
+          }
+          current->thread_time_to_wait = (interval - past_first) - 1;
+        }
+        else {
+          fires += past_first / (current->thread_period + 1);
+          current->thread_time_to_wait = current->thread_period - (past_first % (current->thread_period + 1));
+        }
+#else
+        fires += past_first / (current->thread_period + 1);
+        current->thread_time_to_wait = current->thread_period - (past_first % (current->thread_period + 1));
+#endif
+        this->publishFire(current);
+        /* An accumulating schedule is owed every firing the gap swallowed, exactly as
+           if the ticks had been delivered one at a time. The check on the owed count
+           keeps a muted (or otherwise unpublished) firing from accruing debt. */
+        if ((fires > 1) && current->thread_accumulates && fires_owed(current)) {
+          uint32_t room  = 0xFF - fires_owed(current);
+          current->thread_fire += (uint8_t) (((fires - 1) > room) ? room : (fires - 1));
+        }
+      }
+    }
+    current = current->next;
+  }
+#endif  // tick-path selection
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  for (int i = 0; i < SCHEDULER_ONESHOT_SLOTS; i++) {
+    if ((this->oneshot_cb[i] != NULL) && !this->oneshot_fired[i]) {
+      if (this->oneshot_ttw[i] >= nu_ticks) this->oneshot_ttw[i] -= nu_ticks;
+      else this->oneshot_fired[i] = true;
+    }
+  }
+#endif
 }
 
 
@@ -535,8 +1933,10 @@ boolean Scheduler::disableSchedule(uint32_t g_pid) {
   ScheduleItem *nu_sched  = findNodeByPID(g_pid);
   if (nu_sched != NULL) {
       nu_sched->thread_enabled = false;
-      nu_sched->thread_fire    = false;
+      fires_clear(nu_sched);
       nu_sched->thread_time_to_wait = nu_sched->thread_period;
+      this->tickPathDetach(nu_sched);
+      this->notifyDeadlineChange();
       return true;
   }
   return false;
@@ -568,59 +1968,155 @@ boolean Scheduler::removeSchedule(uint32_t g_pid) {
 /**
 * This is the function that is called from the main loop to offload big
 *  tasks into idle CPU time. If many scheduled items have fired, function
-*  will only execute the first one it finds.
-*  Therefore: Lower-numbered schedules are de facto higher-priority.
+*  will only execute the one that has been waiting longest.
+*  Therefore: Schedules are serviced in expiry order.
 */
 void Scheduler::serviceScheduledEvents() {
+  this->serviceScheduledEvents(0);
+}
+
+
+/**
+* Budgeted variant of the above. Dispatches fired schedules until either none remain
+*  or micros_budget microseconds have elapsed since this call began, whichever comes
+*  first. A budget of zero means "dispatch at most one schedule", which is the legacy
+*  behavior. The budget is checked between callbacks, so one long-running callback
+*  can still overshoot it; the budget bounds scan-and-dispatch, not callback runtime.
+*/
+void Scheduler::serviceScheduledEvents(uint32_t micros_budget) {
   uint32_t profile_start_time = 0;
   uint32_t profile_last_time  = 0;
   uint32_t origin_time        = micros();
-  ScheduleItem *current = this->schedule_root_node;
-  ScheduleItem *temp;
-  while (current != NULL) {
-    temp = NULL;
-    if (current->thread_fire) {
-      if (current->schedule_callback != NULL) {
-        if (this->scheduleBeingProfiled(current)) profile_start_time = micros();
-        
+  ScheduleItem *current;
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  /* Expired one-shots run first: they are typically protocol timeouts, and freeing
+     their slots promptly keeps runLater() from reporting exhaustion. The slot is
+     released before the callback runs, so the callback may itself re-arm. */
+  for (int i = 0; i < SCHEDULER_ONESHOT_SLOTS; i++) {
+    if (this->oneshot_fired[i] && (this->oneshot_cb[i] != NULL)) {
+      FunctionPointer os_cb  = this->oneshot_cb[i];
+      this->oneshot_cb[i]    = NULL;
+      this->oneshot_fired[i] = false;
+      this->oneshot_gen[i]++;
+      os_cb();
+      this->productive_loops++;
+    }
+  }
+#endif
+#if SCHEDULER_ISR_SAFE
+  // Drain whatever the ISR has published since we last ran into the ready-queue.
+  while ((current = this->isrRingPop()) != NULL) this->readyQueuePush(current);
+#endif
+  while ((current = this->readyQueuePop()) != NULL) {
+    /* A schedule can be queued and then cancelled (disabled, altered) before we get
+       here. Such items pop with nothing owed and are simply discarded, as are
+       firings whose group was muted after they queued. */
+    if (fires_owed(current) && !this->groupPermits(current)) fires_clear(current);
+    if (fires_owed(current)) {
+      if ((current->schedule_callback != NULL) || (current->arg_callback != NULL)) {
+        /* The stats live inline in the node we already hold, so the gate is one flag
+           test and the updates below are compare-and-store: no pointer chase, no
+           second lookup. Cheap enough to leave on fleet-wide in release builds. */
+        if (current->prof_data.profiling_active) {
+          ScheduleProfile *prof  = &current->prof_data;
+          profile_start_time = micros();
+          /* Fire-to-service latency: how long the firing sat in the queue. */
+          uint32_t lat  = profile_start_time - prof->fire_time_micros;
+          prof->latency_last   = lat;
+          prof->latency_total += lat;
+          if (lat < prof->latency_best)  prof->latency_best  = lat;
+          if (lat > prof->latency_worst) prof->latency_worst = lat;
+        }
+
+#if SCHEDULER_WATCHDOG_TICKS > 0
+        /* Each dispatch gets its own sequence number, so the tick side can tell a
+           stuck run from back-to-back runs of the same schedule. */
+        this->dispatch_seq++;
+#endif
         this->currently_executing = current->pid;
-        ((void (*)(void)) current->schedule_callback)();    // Call the schedule's service function.
+        if (current->arg_callback != NULL) {
+          ((void (*)(void*)) current->arg_callback)(current->callback_arg);  // Call the schedule's service function with its argument.
+        }
+        else {
+          ((void (*)(void)) current->schedule_callback)();    // Call the schedule's service function.
+        }
         this->currently_executing = 0;
 
-        if (this->scheduleBeingProfiled(current)) {
+        if (current->prof_data.profiling_active) {
+          ScheduleProfile *prof  = &current->prof_data;
           profile_last_time     = micros();
-          current->prof_data->last_time_micros   = max(profile_start_time, profile_last_time) - min(profile_start_time, profile_last_time);  // Rollover invarient.
-          current->prof_data->worst_time_micros  = max(current->prof_data->worst_time_micros, current->prof_data->last_time_micros);
-          current->prof_data->best_time_micros   = min(current->prof_data->best_time_micros, current->prof_data->last_time_micros);
-          current->prof_data->execution_count++;
-        }            
+          uint32_t ran  = max(profile_start_time, profile_last_time) - min(profile_start_time, profile_last_time);  // Rollover invarient.
+          prof->last_time_micros = ran;
+          prof->execution_count++;
+          if (ran > prof->worst_time_micros) prof->worst_time_micros = ran;
+          if (ran < prof->best_time_micros)  prof->best_time_micros  = ran;
+
+          /* Budget enforcement: persistent overrunners get demoted to the lowest
+             priority class, where they can no longer delay well-behaved tasks. */
+          if (prof->budget_micros > 0) {
+            if (ran > prof->budget_micros) {
+              prof->budget_overruns++;
+              if (++(prof->budget_strikes) >= SCHEDULER_BUDGET_STRIKES) {
+                prof->budget_strikes = 0;
+                if (current->thread_priority < (SCHEDULER_NUM_PRIORITIES - 1)) {
+                  current->thread_priority = SCHEDULER_NUM_PRIORITIES - 1;
+                  this->budget_demotions++;
+                }
+              }
+            }
+            else prof->budget_strikes = 0;
+          }
+        }
       }
-      current->thread_fire = false;
-         
+      if (fires_owed(current)) fires_take(current);       // This run is delivered.
+
+      /* Completed: hand the baton to a chained successor, if one is named. It joins
+         the tail of its ready list, so a whole pipeline drains within this pass. */
+      if (current->chain_pid != 0) {
+        ScheduleItem *succ  = findNodeByPID(current->chain_pid);
+        if (succ != NULL) this->fireNow(succ);
+      }
+
       switch (current->thread_recurs) {
         case -1:           // Do nothing. Schedule runs indefinitely.
           break;
         case 0:            // Disable (and remove?) the schedule.
           if (current->autoclear) {
-            temp = current->next;  // Careful.....
-            this->destroyScheduleItem(current);
-            current = temp;
+            /* Teardown is deferred: destroying inline would put an O(n) unlink scan
+               (and a free()) between callbacks. Mark the node dead and move on; the
+               reap sweep at the end of this pass recycles every dead node at once. */
+            current->thread_enabled = false;
+            fires_clear(current);
+            current->thread_dead    = true;
+            this->reap_count++;
           }
           else {
             current->thread_enabled = false;  // Disable the schedule...
-            current->thread_fire    = false;  // ...mark it as serviced.
+            fires_clear(current);             // ...mark it as serviced.
             current->thread_time_to_wait = current->thread_period;  // ...and reset the timer.
+            this->tickPathDetach(current);    // ...and take it off the tick path until re-enabled.
           }
           break;
         default:           // Decrement the run count.
           current->thread_recurs--;
           break;
       }
+      /* An accumulating schedule still owing runs rejoins the tail of its class, so
+         its backlog drains fairly, interleaved with everything else that fired. */
+      if (fires_owed(current)) this->readyQueuePush(current);
       this->productive_loops++;
-      break;
+      if (micros_budget == 0) break;                            // Legacy one-task-per-call mode.
+      if ((micros() - origin_time) >= micros_budget) break;     // Budget is spent.
     }
-    current = (current == NULL) ? temp : current->next;
   }
+  /* Starvation accounting: anything still queued at this point fired but was not
+     serviced this pass. Normally every class is empty and this is four NULL tests. */
+  for (uint8_t p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    for (ScheduleItem *rem = this->ready_queue_head[p]; rem != NULL; rem = rem->ready_next) {
+      this->class_deferrals[p]++;
+    }
+  }
+  this->reapDeadSchedules();
   this->overhead = micros() - origin_time;
   this->total_loops++;
 }
@@ -633,33 +2129,108 @@ void Scheduler::serviceScheduledEvents() {
 *  memory after you've finished writing the string to a serial port, or whatever you do with it.    *
 ****************************************************************************************************/
 
+/**
+* Streams schedule data into the given sink, one line at a time from a fixed buffer.
+*  Pass 0 as g_pid to get all schedules. Memory use is constant in the schedule count.
+*/
+void Scheduler::printScheduleData(Print &output, uint32_t g_pid, boolean actives_only) {
+  char temp_str[150];
+  output.print("[PID, ENABLED, TTF, PERIOD, RECURS, PENDING, AUTOCLEAR, PROFILED, GROUP]\n");
+  ScheduleItem *current  = this->schedule_root_node;
+  while (current != NULL) {
+    if (((g_pid == 0) | (g_pid == current->pid)) | !actives_only) {
+      char group_str[12];
+      if (current->thread_group == 0) strcpy(group_str, "-");
+      else sprintf(group_str, "%u:%s", current->thread_group, (this->groupEnabled(current->thread_group) ? "EN" : "DIS"));
+      sprintf(temp_str, "[%lu, %s, %lu, %lu, %d, %u, %s, %s, %s]\n", current->pid, ((current->thread_enabled) ? "YES":"NO"), current->thread_time_to_wait, current->thread_period, current->thread_recurs, fires_owed(current), ((current->autoclear) ? "YES":"NO"), ((current->prof_data.profiling_active) ? "YES":"NO"), group_str);
+      output.print(temp_str);
+    }
+    current = current->next;
+  }
+}
+
+/**
+* Streams schedule data for all defined schedules. Active or not.
+*/
+void Scheduler::printScheduleData(Print &output) {
+  this->printScheduleData(output, 0, false);
+}
+
+/**
+* Streams schedule data for the schedule with the given PID.
+*/
+void Scheduler::printScheduleData(Print &output, uint32_t g_pid) {
+  this->printScheduleData(output, g_pid, false);
+}
+
+
+/**
+* Streams profiling data into the given sink, one line at a time from a fixed buffer.
+*  Pass 0 (or 0xFFFFFFFF) as g_pid to get all profiled schedules.
+*/
+void Scheduler::printProfilingData(Print &output, uint32_t g_pid) {
+  char temp_str[150];
+  output.print("[PID, PROFILING, EXECUTED, LAST, BEST, WORST, LAT_LAST, LAT_BEST, LAT_WORST, LAT_AVG, MISSED]\n");
+  ScheduleItem *current  = this->schedule_root_node;
+  while (current != NULL) {
+    if (current->prof_data.profiling_active || (current->prof_data.execution_count > 0)) {
+      if (((g_pid == 0) | (g_pid == current->pid)) | (g_pid == 0xFFFFFFFF)) {
+        sprintf(temp_str, "[%lu, %s, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu]\n", current->pid, ((current->prof_data.profiling_active) ? "YES":"NO"), current->prof_data.execution_count, current->prof_data.last_time_micros, current->prof_data.best_time_micros, current->prof_data.worst_time_micros, current->prof_data.latency_last, current->prof_data.latency_best, current->prof_data.latency_worst, ((current->prof_data.execution_count > 0) ? (current->prof_data.latency_total / current->prof_data.execution_count) : 0), current->prof_data.missed_fires);
+        output.print(temp_str);
+      }
+    }
+    current = current->next;
+  }
+  output.print("[DEFERRALS");
+  for (uint8_t p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+    sprintf(temp_str, " P%u:%lu", p, this->class_deferrals[p]);
+    output.print(temp_str);
+  }
+  output.print("]\n");
+}
+
+/**
+* Streams profiling data for all profiled schedules.
+*/
+void Scheduler::printProfilingData(Print &output) {
+  this->printProfilingData(output, 0);
+}
+
+
 /**
 * Dumps profiling data for the schedule with the given PID.
 */
 char* Scheduler::dumpProfilingData(uint32_t g_pid) {
-  const char* PROFILER_HEADER = "[PID, PROFILING, EXECUTED, LAST, BEST, WORST]\n";
+  const char* PROFILER_HEADER = "[PID, PROFILING, EXECUTED, LAST, BEST, WORST, LAT_LAST, LAT_BEST, LAT_WORST, LAT_AVG, MISSED]\n";
   char* return_value  = NULL;
   const uint16_t EXPECTED_SIZE_OF_LINE = 140;
   uint16_t num_strs  = this->getTotalSchedules();
   if (num_strs > 0) {
     ScheduleItem *current  = this->schedule_root_node;
-    char* temp_str_out  = (char*) alloca(EXPECTED_SIZE_OF_LINE * num_strs);  // Arbitrary. Slightly too big. Should not overflow.
+    char* temp_str_out  = (char*) alloca(EXPECTED_SIZE_OF_LINE * (num_strs + 1));  // Arbitrary. Slightly too big. Should not overflow.
     if (temp_str_out != NULL) {
-      memset(temp_str_out, 0x00, EXPECTED_SIZE_OF_LINE * num_strs);
+      memset(temp_str_out, 0x00, EXPECTED_SIZE_OF_LINE * (num_strs + 1));
       char* temp_str  = (char*) alloca(EXPECTED_SIZE_OF_LINE);  // Arbitrary. Slightly too big. Should not overflow.
       memset(temp_str, 0x00, EXPECTED_SIZE_OF_LINE);
       strcat(temp_str_out, PROFILER_HEADER);    // Write the header.
   
       while (current != NULL) {
-        if (current->prof_data != NULL) {
+        if (current->prof_data.profiling_active || (current->prof_data.execution_count > 0)) {
 	  if (((g_pid == 0) | (g_pid == current->pid)) | (g_pid == 0xFFFFFFFF)) {
-            sprintf(temp_str, "[%lu, %s, %lu, %lu, %lu, %lu]\n", current->pid, ((current->prof_data->profiling_active) ? "YES":"NO"), current->prof_data->execution_count, current->prof_data->last_time_micros, current->prof_data->best_time_micros, current->prof_data->worst_time_micros);
+            sprintf(temp_str, "[%lu, %s, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu]\n", current->pid, ((current->prof_data.profiling_active) ? "YES":"NO"), current->prof_data.execution_count, current->prof_data.last_time_micros, current->prof_data.best_time_micros, current->prof_data.worst_time_micros, current->prof_data.latency_last, current->prof_data.latency_best, current->prof_data.latency_worst, ((current->prof_data.execution_count > 0) ? (current->prof_data.latency_total / current->prof_data.execution_count) : 0), current->prof_data.missed_fires);
             strcat(temp_str_out, temp_str);
             memset(temp_str, 0x00, EXPECTED_SIZE_OF_LINE);
 	  }
         }
         current = current->next;
       }
+      // Starvation accounting: how many fired schedules each priority class has left waiting.
+      strcat(temp_str_out, "[DEFERRALS");
+      for (uint8_t p = 0; p < SCHEDULER_NUM_PRIORITIES; p++) {
+        sprintf(temp_str, " P%u:%lu", p, this->class_deferrals[p]);
+        strcat(temp_str_out, temp_str);
+      }
+      strcat(temp_str_out, "]\n");
       return_value = strdup(temp_str_out);
     }
     else {
@@ -681,11 +2252,42 @@ char* Scheduler::dumpProfilingData() {
 }
 
 
+/**
+* Binary telemetry export: packs one ScheduleProfileRecord per actively-profiled
+*  schedule into the given buffer, in list order, and returns the bytes written. No
+*  formatting and no allocation; the single pass is a memcpy per record, so the cost
+*  is a small fraction of the text dumps and the result is ready for DMA as-is.
+*  Records are only written whole: a buffer too small for everything yields a
+*  truncated but well-formed snapshot.
+*/
+size_t Scheduler::exportProfileSnapshot(uint8_t* buf, size_t len) {
+  size_t return_value  = 0;
+  if (buf != NULL) {
+    ScheduleItem *current  = this->schedule_root_node;
+    while (current != NULL) {
+      if (current->prof_data.profiling_active) {
+        if ((len - return_value) < sizeof(ScheduleProfileRecord)) break;
+        ScheduleProfileRecord record;
+        record.pid                = current->pid;
+        record.execution_count    = current->prof_data.execution_count;
+        record.last_time_micros   = current->prof_data.last_time_micros;
+        record.best_time_micros   = current->prof_data.best_time_micros;
+        record.worst_time_micros  = current->prof_data.worst_time_micros;
+        memcpy(buf + return_value, &record, sizeof(ScheduleProfileRecord));
+        return_value += sizeof(ScheduleProfileRecord);
+      }
+      current = current->next;
+    }
+  }
+  return return_value;
+}
+
+
 /**
 * Dumps schedule data. Pass 0 as the first parameter to get all processes.
 */
 char* Scheduler::dumpScheduleData(uint32_t g_pid, boolean actives_only) {
-  const char* SCHEDULE_HEADER = "[PID, ENABLED, TTF, PERIOD, RECURS, PENDING, AUTOCLEAR, PROFILED]\n";
+  const char* SCHEDULE_HEADER = "[PID, ENABLED, TTF, PERIOD, RECURS, PENDING, AUTOCLEAR, PROFILED, GROUP]\n";
   char* return_value  = NULL;
   const uint16_t EXPECTED_SIZE_OF_LINE = 146;
   uint16_t num_strs  = this->getTotalSchedules();
@@ -700,7 +2302,10 @@ char* Scheduler::dumpScheduleData(uint32_t g_pid, boolean actives_only) {
   
       while (current != NULL) {
 	if (((g_pid == 0) | (g_pid == current->pid)) | !actives_only){
-          sprintf(temp_str, "[%lu, %s, %lu, %lu, %d, %s, %s, %s]\n", current->pid, ((current->thread_enabled) ? "YES":"NO"), current->thread_time_to_wait, current->thread_period, current->thread_recurs, ((current->thread_fire) ? "YES":"NO"), ((current->autoclear) ? "YES":"NO"), ((current->prof_data != NULL && current->prof_data->profiling_active) ? "YES":"NO"));
+          char group_str[12];
+      if (current->thread_group == 0) strcpy(group_str, "-");
+      else sprintf(group_str, "%u:%s", current->thread_group, (this->groupEnabled(current->thread_group) ? "EN" : "DIS"));
+      sprintf(temp_str, "[%lu, %s, %lu, %lu, %d, %u, %s, %s, %s]\n", current->pid, ((current->thread_enabled) ? "YES":"NO"), current->thread_time_to_wait, current->thread_period, current->thread_recurs, fires_owed(current), ((current->autoclear) ? "YES":"NO"), ((current->prof_data.profiling_active) ? "YES":"NO"), group_str);
           strcat(temp_str_out, temp_str);
           memset(temp_str, 0x00, EXPECTED_SIZE_OF_LINE);
 	}
@@ -40,32 +40,344 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #endif
 
 
+/* Tick-path strategy...
+   By default, advanceScheduler() walks every ScheduleItem on every tick, which is O(n)
+   work inside what is probably your timer ISR. If you have many schedules, define
+   SCHEDULER_WHEEL_BUCKETS (must be a power of two, 32 is a sane choice) and the
+   scheduler will bucket items by expiry into a hashed timing-wheel. A tick then only
+   touches the one bucket that is due, making ISR cost O(tasks-due) rather than O(n).
+   The public API is identical either way. */
+#ifndef SCHEDULER_WHEEL_BUCKETS
+  #define SCHEDULER_WHEEL_BUCKETS 0
+#endif
+
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  #if (SCHEDULER_WHEEL_BUCKETS & (SCHEDULER_WHEEL_BUCKETS - 1)) != 0
+    #error SCHEDULER_WHEEL_BUCKETS must be a power of two.
+  #endif
+#endif
+
+/* The other tick-path option: the classic delta-queue. Schedules are kept in a second
+   list sorted by time-to-fire, with each node storing its wait as a delta from its
+   predecessor. A tick decrements only the head, so tick cost is O(1) when nothing is
+   due regardless of schedule count. Insertion is O(n), which is the right trade for
+   modest schedule counts (a few dozen); prefer the wheel when you have hundreds.
+   Define SCHEDULER_DELTA_QUEUE to 1 to select it. Mutually exclusive with the wheel. */
+#ifndef SCHEDULER_DELTA_QUEUE
+  #define SCHEDULER_DELTA_QUEUE 0
+#endif
+
+#if SCHEDULER_DELTA_QUEUE && (SCHEDULER_WHEEL_BUCKETS > 0)
+  #error SCHEDULER_DELTA_QUEUE and SCHEDULER_WHEEL_BUCKETS are mutually exclusive.
+#endif
+
+/* Priority classes...
+   Fired schedules are serviced from per-class ready lists, highest class first (class 0
+   is the highest). Within a class, order is expiry order. New schedules land in the
+   lowest class; promote the ones with latency requirements via setSchedulePriority().
+   Each class keeps a deferral counter (class_deferrals[]) that grows by one for every
+   fired schedule left waiting when serviceScheduledEvents() returns, which is the
+   number to watch when you suspect low-priority work is starving. The counters appear
+   at the end of dumpProfilingData(). */
+#ifndef SCHEDULER_NUM_PRIORITIES
+  #define SCHEDULER_NUM_PRIORITIES 4
+#endif
+
+/* Interrupt safety...
+   The intended drive arrangement is advanceScheduler() in a timer ISR with everything
+   else in the main loop. By default, the two sides share the ready-queue and the
+   schedule list directly, which obliges the caller to bracket API calls with
+   noInterrupts()/interrupts(). Defining SCHEDULER_ISR_SAFE to 1 changes the handoff:
+   the ISR publishes due nodes through a single-producer/single-consumer ring buffer
+   (SCHEDULER_ISR_RING_SIZE entries, power of two) and touches nothing else that the
+   main loop writes, so no interrupt masking is needed on the hot path at all. The
+   main-loop side drains the ring into the ready-queue at the top of each
+   serviceScheduledEvents() call. The pending-run count follows the same
+   single-writer discipline as the ring cursors: the ISR only ever increments the
+   fires-produced counter and the main loop only ever advances its fires-taken
+   counter, so an expiry that lands mid-dispatch cannot be erased by a torn
+   read-modify-write on either side.
+   Two caveats:
+   - This relies on aligned 32-bit loads/stores being single-copy atomic, which holds
+     on the ARM targets (Teensy 3.x, Due) but NOT on 8-bit AVR.
+   - It composes with the default (linear) tick path only. The timing-wheel links are
+     written by both sides and cannot be made safe this way.
+   If the ring is full when a schedule expires, that firing is dropped and counted in
+   isr_ring_overflows; size the ring for your worst simultaneous-expiry burst. */
+#ifndef SCHEDULER_ISR_SAFE
+  #define SCHEDULER_ISR_SAFE 0
+#endif
+
+#ifndef SCHEDULER_ISR_RING_SIZE
+  #define SCHEDULER_ISR_RING_SIZE 32
+#endif
+
+#if SCHEDULER_ISR_SAFE
+  #if (SCHEDULER_WHEEL_BUCKETS > 0) || SCHEDULER_DELTA_QUEUE
+    #error SCHEDULER_ISR_SAFE requires the default (linear) tick path.
+  #endif
+  #if (SCHEDULER_ISR_RING_SIZE & (SCHEDULER_ISR_RING_SIZE - 1)) != 0
+    #error SCHEDULER_ISR_RING_SIZE must be a power of two.
+  #endif
+  // Keeps the compiler from reordering stores across the publication points.
+  #define SCHEDULER_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/* Allocation strategy...
+   By default, ScheduleItem structs are malloc()'d and free()'d as schedules come and
+   go. On long-uptime targets that churn schedules (autoclear one-shots especially),
+   heap fragmentation will eventually bite you. Defining SCHEDULER_POOL_SIZE to a
+   non-zero value reserves that many statically at build time and serves all requests
+   from a free-list: acquisition and release become a couple of pointer swaps,
+   deterministic in time, and the heap is never touched. It also makes the scheduler's
+   worst-case memory footprint a number you can read off the map file. When the pool is
+   exhausted, createSchedule() fails the same way it does when malloc() fails. The pool
+   is shared by all Scheduler instances.
+   The pool also changes how PIDs are made. The heap build hands out PIDs from a bare
+   counter, which after 2^32 creations wraps and can collide with a PID still live — a
+   reachable hazard on a one-shot-heavy workload with months of uptime. Pool-build PIDs
+   instead encode their slot in the low half and a per-slot generation count in the high
+   half: allocation is find-first-set over a free-bitmap, live PIDs are unique by
+   construction (one slot, one live PID), and a recycled slot's new generation stales
+   every handle ever issued for its previous occupants. */
+#ifndef SCHEDULER_POOL_SIZE
+  #define SCHEDULER_POOL_SIZE 0
+#endif
+
+#if SCHEDULER_POOL_SIZE > 65535
+  #error SCHEDULER_POOL_SIZE must be 65535 or fewer, so a slot fits in the low half of a PID.
+#endif
+
+/* PID lookup strategy...
+   Every public entry point that takes a PID resolves it via findNodeByPID(). By default
+   that is backed by an open-addressing hash index sized SCHEDULER_PID_TABLE_SIZE (must be
+   a power of two), making lookups O(1) for up to that many live schedules. If you define
+   it to more schedules than you will ever have live at once, the index never degrades.
+   Should the table fill up, the linked-list walk remains as a fallback, so correctness
+   never depends on the index. Define it to 0 to strip the index and its RAM cost.
+   With the static pool enabled, a PID decodes straight to its slot and the hash index
+   would be redundant, so it is compiled out regardless of the setting here. */
+#ifndef SCHEDULER_PID_TABLE_SIZE
+  #define SCHEDULER_PID_TABLE_SIZE 64
+#endif
+
+#if SCHEDULER_POOL_SIZE > 0
+  #undef SCHEDULER_PID_TABLE_SIZE
+  #define SCHEDULER_PID_TABLE_SIZE 0
+#endif
+
+#if SCHEDULER_PID_TABLE_SIZE > 0
+  #if (SCHEDULER_PID_TABLE_SIZE & (SCHEDULER_PID_TABLE_SIZE - 1)) != 0
+    #error SCHEDULER_PID_TABLE_SIZE must be a power of two.
+  #endif
+#endif
+
+
+/* One-shot timer slots...
+   Fire-once-and-discard timers (protocol timeouts, debounce windows) are a poor fit
+   for the full schedule machinery: each one pays PID assignment, list insertion, and
+   eventual teardown just to run a callback once. Defining SCHEDULER_ONESHOT_SLOTS
+   non-zero reserves that many fixed slots inside the Scheduler object for
+   runLater(): arming is a scan for a free slot starting at a rotating cursor
+   (amortized O(1)), cancellation via the returned handle is O(1), and the storage is
+   never allocated or freed. Slots tick alongside the main schedule list in every
+   tick strategy. Costs ten bytes per slot. */
+#ifndef SCHEDULER_ONESHOT_SLOTS
+  #define SCHEDULER_ONESHOT_SLOTS 0
+#endif
+
+#if SCHEDULER_ONESHOT_SLOTS > 256
+  #error SCHEDULER_ONESHOT_SLOTS must be 256 or fewer.
+#endif
+
+
+/* Fixed-point periods...
+   Integer periods quantize every firing interval to whole ticks, so a rate that does
+   not divide the tick frequency (a 333.33Hz loop on a 1kHz tick, say) drifts steadily
+   out of phase. Defining SCHEDULER_FIXED_POINT non-zero adds a per-schedule firing
+   interval expressed in 16.16 fixed-point ticks (see alterSchedulePeriodFixed()). The
+   fractional part is carried forward from firing to firing, so individual intervals
+   still land on tick boundaries but the long-run average rate is exact: the task
+   holds phase indefinitely instead of accumulating a tick of error every 1/frac
+   firings. Costs six bytes per ScheduleItem. */
+#ifndef SCHEDULER_FIXED_POINT
+  #define SCHEDULER_FIXED_POINT 0
+#endif
+
+
+/* Execution-budget enforcement: how many consecutive over-budget runs a schedule is
+   allowed before it is demoted to the lowest priority class. A compliant run resets
+   the count, so a task has to be persistently over budget to be demoted, not merely
+   unlucky once. See setExecutionBudget(). */
+#ifndef SCHEDULER_BUDGET_STRIKES
+  #define SCHEDULER_BUDGET_STRIKES 3
+#endif
+
+
+/* Automatic phase spreading...
+   Every schedule starts life with its countdown set to a full period, so tasks that
+   are created together and share a period fire on the same tick forever: the service
+   pass sees a deep backlog on that tick and nothing on its neighbors. Defining
+   SCHEDULER_AUTO_PHASE non-zero staggers each new schedule one tick behind the
+   schedules that already share its period, which flattens the per-tick fire
+   distribution without changing any task's rate. Only schedules created without an
+   explicit phase are spread; a phase given at creation (or coalesceSchedule()) always
+   wins, since deliberate grouping is sometimes the point. Costs one walk of the
+   schedule list per creation and nothing at runtime. */
+#ifndef SCHEDULER_AUTO_PHASE
+  #define SCHEDULER_AUTO_PHASE 0
+#endif
+
+
+/* Stuck-task supervision...
+   A callback that never returns (or chronically overruns) starves the whole loop, and
+   a bare hardware-watchdog reset destroys the evidence of which task it was. Defining
+   SCHEDULER_WATCHDOG_TICKS non-zero makes advanceScheduler() watch the in-flight
+   dispatch: if the same run of the same schedule is still executing after more than
+   that many ticks, the offending PID and a running incident count are recorded
+   (watchdog_stuck_pid, watchdog_stuck_events) and the hook given to
+   setWatchdogCallback(), if any, is invoked once per incident. The hook runs in
+   whatever context delivers ticks — usually the timer ISR, which is exactly what makes
+   it useful: it still runs while the main loop is wedged, in time to stash forensics
+   before the hardware watchdog fires. Happy-path cost is one compare per tick when no
+   callback is in flight, two when one is. */
+#ifndef SCHEDULER_WATCHDOG_TICKS
+  #define SCHEDULER_WATCHDOG_TICKS 0
+#endif
+
+
 // We need to def a few types... First, let's def a function pointer to avoid
 // cluttering things up with unreadable casts...
 
 typedef void (*FunctionPointer) ();
 
+/* The argument-carrying flavor. The void* given at creation rides along in the
+   ScheduleItem and is passed back verbatim at dispatch, which spares tasks that need
+   context from reading globals, and C++ drivers from keeping per-instance trampoline
+   functions just to bind an object pointer. */
+typedef void (*ArgFunctionPointer) (void*);
+
+/* Handed the new result of ticksUntilNextFire() whenever a control-plane call moves
+   the soonest deadline. See setDeadlineCallback(). */
+typedef void (*DeadlineFunctionPointer) (uint32_t);
+
+/* Handed the offending PID and its ticks-in-flight when stuck-task supervision trips.
+   See SCHEDULER_WATCHDOG_TICKS and setWatchdogCallback(). */
+typedef void (*WatchdogFunctionPointer) (uint32_t, uint32_t);
+
+/* Returned by ticksUntilNextFire() when no enabled schedule exists: nothing will ever
+   come due, so the caller may sleep indefinitely. */
+#define SCHEDULER_TICKS_INDEFINITE 0xFFFFFFFF
+
+/* "No phase was specified": the schedule takes the legacy full-period countdown, or
+   the spread placement under SCHEDULER_AUTO_PHASE. Not a legal explicit phase. */
+#define SCHEDULER_PHASE_DEFAULT 0xFFFFFFFF
+
+/* Missed-event policies, per schedule (see setFirePolicy()). Under COALESCE (the
+   default, and the historical behavior), expiries that pile up before the schedule is
+   serviced collapse into a single run — right for idempotent work like a display
+   refresh. Under ACCUMULATE, every expiry owes a run: the pending count saturates at
+   255 and serviceScheduledEvents() dispatches once per owed firing, so a task that
+   must run once per expiry (a counter drain, say) no longer needs its period
+   over-provisioned to avoid losing executions. */
+#define SCHEDULER_FIRES_COALESCE   0
+#define SCHEDULER_FIRES_ACCUMULATE 1
+
+/* One row of a bulk-creation table for createSchedules(). Boot sequences that register
+   many schedules can declare them all in one const array instead of a run of calls. */
+typedef struct {
+  uint32_t period;           // The period of the schedule service routine.
+  int16_t  recurrence;       // How many times should this schedule run?
+  boolean  autoclear;        // When recurrence reaches 0, should the schedule be reaped?
+  FunctionPointer callback;  // The service function.
+  uint8_t  group;            // Subsystem group (1..32), or zero for none.
+  uint8_t  policy;           // Missed-event policy. SCHEDULER_FIRES_COALESCE by default.
+} ScheduleDef;
+
 // Data associated with profiling schedules...
 typedef struct sch_item_prof_t {
   uint32_t last_time_micros;   // Last execution time, in microseconds.
   uint32_t worst_time_micros;  // Worst execution time, in microseconds.
   uint32_t best_time_micros;   // Best execution time, in microseconds.
   uint32_t execution_count;    // Number of times this schedule has executed.
+  uint32_t budget_micros;      // Declared runtime budget. Zero means unenforced.
+  uint32_t budget_overruns;    // Lifetime count of runs that exceeded the budget.
+  uint32_t fire_time_micros;   // When did the pending firing happen? Stamped at expiry.
+  uint32_t latency_last;       // Most recent fire-to-service latency, in microseconds.
+  uint32_t latency_best;       // Best fire-to-service latency, in microseconds.
+  uint32_t latency_worst;      // Worst fire-to-service latency, in microseconds.
+  uint32_t latency_total;      // Sum of all latencies, for the average. Wraps eventually.
+  uint32_t missed_fires;       // Expiries that found the prior firing still unserviced.
+  uint8_t  budget_strikes;     // Consecutive overruns. Reset by a compliant run.
   boolean  profiling_active;   // Is this data being actively refreshed?
 } ScheduleProfile;
 
+/* One record of the binary telemetry export (see exportProfileSnapshot()). All fields
+   are uint32_t, so the layout is fixed at 20 bytes with no padding on any sane target,
+   and a receiver can parse it with a struct of its own. Values are in the MCU's native
+   byte order; the receiving end of a telemetry link is normally configured per-build
+   anyway, and swabbing on the MCU would defeat the point of the binary path. */
+typedef struct {
+  uint32_t pid;                // Which schedule this record describes.
+  uint32_t execution_count;    // Number of times the schedule has executed.
+  uint32_t last_time_micros;   // Last execution time, in microseconds.
+  uint32_t best_time_micros;   // Best execution time, in microseconds.
+  uint32_t worst_time_micros;  // Worst execution time, in microseconds.
+} ScheduleProfileRecord;
+
 // Type for schedule items...
+// Field order matters: the members the tick path reads every tick are packed together
+//  at the front of the struct so they land in the same cache line; the cold bookkeeping
+//  (identity, callbacks, links, profiling) follows. With the static pool enabled
+//  (SCHEDULER_POOL_SIZE), the items also sit in one contiguous slab and the linear tick
+//  path walks that slab in slot order, which turns the per-tick walk into a sequential
+//  sweep instead of a pointer chase.
 typedef struct sch_item_t {
-  struct sch_item_t* next;             // This will be a linked-list.
-  struct sch_item_prof_t* prof_data;   // If this schedule is being profiled, the ref will be here.
-  uint32_t pid;                        // The process ID of this item. Zero is invalid.
+  /* Hot: read (and often written) by every tick. */
   uint32_t thread_time_to_wait;        // How much longer until the schedule fires?
   uint32_t thread_period;              // How often does this schedule execute?
-  int16_t  thread_recurs;              // See Note 2.
   boolean  thread_enabled;             // Is the schedule running?
-  boolean  thread_fire;                // Is the schedule to be executed?
+  uint8_t  thread_fire;                // Executions presently owed. Non-zero means pending service.
+#if SCHEDULER_ISR_SAFE
+  uint8_t  thread_fires_taken;         // Executions delivered. Main-loop-owned: in this mode thread_fire
+                                       //  is the tick side's produced tally, and what is owed is the
+                                       //  difference between the two, so neither side ever writes a
+                                       //  counter the other increments.
+#endif
+  boolean  thread_accumulates;         // Missed-event policy. See SCHEDULER_FIRES_ACCUMULATE.
+  boolean  thread_queued;              // Is the schedule presently linked into the ready-queue?
+  uint8_t  thread_priority;            // Which ready list does this schedule fire into? 0 is highest.
+  uint8_t  thread_group;               // Subsystem group (1..32) this schedule belongs to. Zero means none.
+  /* Cold: touched at dispatch or by the control plane. */
+  int16_t  thread_recurs;              // See Note 2.
   boolean  autoclear;                  // If true, this schedule will be removed after its last execution.
+  boolean  thread_dead;                // Expired autoclear schedule awaiting the deferred reap sweep.
+  uint32_t pid;                        // The process ID of this item. Zero is invalid.
+  struct sch_item_t* next;             // This will be a linked-list.
+  struct sch_item_t* ready_next;       // Link in the ready-queue of fired schedules awaiting service.
+  ScheduleProfile prof_data;           // Profiling stats, gathered while prof_data.profiling_active is set.
   FunctionPointer schedule_callback;   // Pointers to the schedule service function.
+  ArgFunctionPointer arg_callback;     // Argument-taking service function. Mutually exclusive with the above.
+  void*    callback_arg;               // User argument handed to arg_callback at dispatch.
+  uint32_t chain_pid;                  // PID to fire when this schedule completes. Zero means no successor.
+#if SCHEDULER_POOL_SIZE > 0
+  void*    owner;                      // The Scheduler this slot belongs to. NULL while the slot is free.
+#endif
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  struct sch_item_t* wheel_next;       // Link to the next item in our wheel bucket.
+  struct sch_item_t* wheel_prev;       // Link to the prior item in our wheel bucket. Needed for O(1) removal.
+  uint32_t wheel_rounds;               // How many more full wheel revolutions until this item is due?
+  int16_t  wheel_bucket;               // Which bucket is this item filed in? -1 if not filed.
+#endif
+#if SCHEDULER_DELTA_QUEUE
+  struct sch_item_t* delta_next;       // Link to the next item in the deadline-sorted delta chain.
+  uint32_t delta_ttw;                  // Ticks until due, expressed relative to our predecessor.
+  boolean  delta_linked;               // Is this item presently in the delta chain?
+#endif
+#if SCHEDULER_FIXED_POINT
+  uint32_t thread_period_fp;           // Firing interval in 16.16 fixed-point ticks. Zero means integer mode.
+  uint16_t fp_accumulator;             // Fractional ticks carried from firing to firing.
+#endif
 } ScheduleItem;
 
 
@@ -81,10 +393,47 @@ typedef struct sch_item_t {
 
 // This is the only version I've tested...
 class Scheduler {
+#if SCHEDULER_POOL_SIZE == 0
   uint32_t next_pid;                       // Next PID to assign.
+#endif
   ScheduleItem* schedule_root_node;        // The root of the linked lists in this scheduler.
+  ScheduleItem* schedule_tail_node;        // Cached tail of same, so appends are O(1).
   uint32_t currently_executing;	           // Hold PID of currently-executing Schedule. 0 if none.
-  
+  ScheduleItem* ready_queue_head[SCHEDULER_NUM_PRIORITIES];  // Fired schedules awaiting service, one expiry-ordered list per class.
+  ScheduleItem* ready_queue_tail[SCHEDULER_NUM_PRIORITIES];  // Tails of same, for O(1) append.
+#if SCHEDULER_WHEEL_BUCKETS > 0
+  ScheduleItem* wheel_buckets[SCHEDULER_WHEEL_BUCKETS];  // Heads of the per-bucket expiry lists.
+  uint32_t wheel_tick;                     // Monotonic tick counter. Selects the due bucket.
+#endif
+#if SCHEDULER_DELTA_QUEUE
+  ScheduleItem* delta_root;                // Head of the deadline-sorted delta chain.
+#endif
+#if SCHEDULER_PID_TABLE_SIZE > 0
+  uint32_t      pid_index_keys[SCHEDULER_PID_TABLE_SIZE];  // PID in each index slot. 0 means the slot is empty.
+  ScheduleItem* pid_index_refs[SCHEDULER_PID_TABLE_SIZE];  // Node for each slot. NULL with a non-zero key is a tombstone.
+#endif
+#if SCHEDULER_ISR_SAFE
+  ScheduleItem* volatile isr_ring[SCHEDULER_ISR_RING_SIZE];  // SPSC handoff ring. ISR writes, main loop reads.
+  volatile uint16_t isr_ring_head;         // Producer cursor. Written only by the ISR side.
+  volatile uint16_t isr_ring_tail;         // Consumer cursor. Written only by the main-loop side.
+#endif
+  DeadlineFunctionPointer deadline_callback;  // Invoked when a control-plane call moves the soonest deadline.
+#if SCHEDULER_WATCHDOG_TICKS > 0
+  WatchdogFunctionPointer watchdog_callback;  // Invoked (from tick context) when a dispatch is caught stuck.
+  uint32_t dispatch_seq;                   // Bumped at every dispatch, so back-to-back runs of one PID are told apart.
+  uint32_t watchdog_mark_seq;              // Which dispatch the tick side is currently watching.
+  uint32_t watchdog_ticks_in;              // How many ticks that dispatch has been in flight.
+#endif
+  uint32_t group_enable_mask;              // One bit per group. A clear bit mutes every schedule in that group.
+  uint16_t reap_count;                     // How many dead nodes await the deferred reap sweep.
+#if SCHEDULER_ONESHOT_SLOTS > 0
+  uint32_t oneshot_ttw[SCHEDULER_ONESHOT_SLOTS];         // Countdown per slot.
+  FunctionPointer oneshot_cb[SCHEDULER_ONESHOT_SLOTS];   // Callback per slot. NULL while the slot is free.
+  boolean  oneshot_fired[SCHEDULER_ONESHOT_SLOTS];       // Expired, awaiting service.
+  uint8_t  oneshot_gen[SCHEDULER_ONESHOT_SLOTS];         // Generation counter. Stales old handles.
+  uint8_t  oneshot_cursor;                               // Where the next free-slot scan starts.
+#endif
+
   public:
     Scheduler();   // Constructor
     ~Scheduler();  // Destructor
@@ -95,6 +444,15 @@ class Scheduler {
     uint32_t productive_loops;  // Number of calls to serviceScheduledEvents() that actually called a schedule.
     uint32_t total_loops;       // Number of calls to serviceScheduledEvents().
     uint32_t overhead;          // The time in microseconds required to service the last empty schedule loop.
+#if SCHEDULER_ISR_SAFE
+    uint32_t isr_ring_overflows;  // Firings dropped because the handoff ring was full.
+#endif
+    uint32_t class_deferrals[SCHEDULER_NUM_PRIORITIES];  // Fired-but-left-waiting counts, per priority class.
+    uint32_t budget_demotions;  // Number of schedules demoted for persistent budget overruns.
+#if SCHEDULER_WATCHDOG_TICKS > 0
+    uint32_t watchdog_stuck_pid;     // PID of the most recent schedule caught stuck. Zero if none ever was.
+    uint32_t watchdog_stuck_events;  // How many stuck incidents supervision has recorded.
+#endif
 
     uint16_t getTotalSchedules(void);   // How many total schedules are present?
     uint16_t getActiveSchedules(void);  // How many active schedules are present?
@@ -109,8 +467,32 @@ class Scheduler {
     boolean alterSchedule(uint32_t schedule_index, uint32_t sch_period, int16_t recurrence, boolean auto_clear, FunctionPointer sch_callback);
     boolean alterSchedule(uint32_t schedule_index, boolean auto_clear);
     boolean alterSchedule(uint32_t schedule_index, FunctionPointer sch_callback);
+    boolean alterSchedule(uint32_t schedule_index, ArgFunctionPointer sch_callback, void* arg);
     boolean alterScheduleRecurrence(uint32_t schedule_index, int16_t recurrence);
     boolean alterSchedulePeriod(uint32_t schedule_index, uint32_t sch_period);
+
+#if SCHEDULER_FIXED_POINT
+    /* Puts the schedule in drift-free mode with the given firing interval, expressed
+     * in 16.16 fixed-point ticks: 0x00030000 fires every 3 ticks exactly, 0x00030001
+     * every 3 + 1/65536 ticks on average. Unlike the legacy period (which fires every
+     * period + 1 ticks), the fixed-point value IS the whole interval. The minimum is
+     * 0x00020000 (two ticks), matching the floor the integer API imposes. Pass zero
+     * to return the schedule to integer-period mode. */
+    boolean alterSchedulePeriodFixed(uint32_t schedule_index, uint32_t period_fp_ticks);
+#endif
+
+    /* Moves the schedule into the given priority class (0 is highest). Takes effect
+     * from the schedule's next firing. Returns false on a bad PID or class. */
+    boolean setSchedulePriority(uint32_t g_pid, uint8_t priority);
+
+    /* Declares a runtime budget (in microseconds) for the given schedule, turning
+     * profiling on for it if necessary. A run that measures over budget counts a
+     * strike; SCHEDULER_BUDGET_STRIKES consecutive strikes demote the schedule to
+     * the lowest priority class so it can no longer delay well-behaved tasks, and
+     * increment budget_demotions. Overruns are tallied per-schedule regardless
+     * (see getBudgetOverruns()). A budget of zero ends enforcement. */
+    boolean setExecutionBudget(uint32_t g_pid, uint32_t micros_budget);
+    uint32_t getBudgetOverruns(uint32_t g_pid);   // Lifetime over-budget run count for the given schedule.
     
     /* Add a new schedule. Returns the PID. If zero is returned, function failed.
      * 
@@ -121,25 +503,145 @@ class Scheduler {
      * sch_callback    The service function. Must be a pointer to a (void fxn(void)).
      */    
     uint32_t createSchedule(uint32_t sch_period, int16_t recurrence, boolean auto_clear, FunctionPointer sch_callback);
-    
+
+    /* As above, but the service function takes the given argument at each dispatch.
+     * No extra allocation or indirection; the argument is stored inline in the item. */
+    uint32_t createSchedule(uint32_t sch_period, int16_t recurrence, boolean auto_clear, ArgFunctionPointer sch_callback, void* arg);
+
+    /* As above, with an explicit phase: the first firing lands (phase + 1) ticks from
+     * now instead of a full period out, and the cadence continues from there. Phase is
+     * taken modulo (period + 1), so phase == period reproduces the default placement
+     * and phase 0 fires on the very next tick. Same-period tasks given distinct phases
+     * never share a tick; tasks given the same phase always do. */
+    uint32_t createSchedule(uint32_t sch_period, int16_t recurrence, boolean auto_clear, FunctionPointer sch_callback, uint32_t phase);
+    uint32_t createSchedule(uint32_t sch_period, int16_t recurrence, boolean auto_clear, ArgFunctionPointer sch_callback, void* arg, uint32_t phase);
+
+    /* Bulk creation: registers count schedules from the given table in one pass.
+     * Returns how many were created (less than count means storage ran out). If pids
+     * is non-NULL, the new PID (or zero, on failure) is written there per row. */
+    uint16_t createSchedules(const ScheduleDef* defs, uint16_t count, uint32_t* pids);
+
+
     boolean scheduleEnabled(uint32_t g_pid);   // Is the given schedule presently enabled?
 
     boolean enableSchedule(uint32_t g_pid);   // Re-enable a previously-disabled schedule.
     boolean disableSchedule(uint32_t g_pid);  // Turn a schedule off without removing it.
+
+    /* Subsystem groups. Schedules can be filed into one of 32 groups (radio, UI,
+     * logging...) and a whole group muted or unmuted by flipping one mask bit; no
+     * list walk, no per-PID calls, O(1) regardless of group size. A muted schedule
+     * keeps its cadence (countdowns keep running) but its firings are suppressed,
+     * and firings already queued when the group goes quiet are dropped unrun.
+     * Group zero means ungrouped and is never muted. */
+    /* Sets the schedule's missed-event policy (SCHEDULER_FIRES_COALESCE or
+     * SCHEDULER_FIRES_ACCUMULATE). Intended to be called right after creation, before
+     * the first expiry; a ScheduleDef row can carry the policy instead. Switching to
+     * COALESCE forgives any backlog beyond the one run already owed. */
+    boolean setFirePolicy(uint32_t g_pid, uint8_t policy);
+
+    boolean setScheduleGroup(uint32_t g_pid, uint8_t group);  // Files the schedule into a group. Zero to unfile.
+    boolean enableGroup(uint8_t group);                       // Unmutes every schedule in the group.
+    boolean disableGroup(uint8_t group);                      // Mutes every schedule in the group.
+    boolean groupEnabled(uint8_t group);                      // Is the given group unmuted?
     boolean removeSchedule(uint32_t g_pid);   // Clears all data relating to the given schedule.
     boolean delaySchedule(uint32_t g_pid, uint32_t by_ms);  // Set the schedule's TTW to the given value this execution only.
     boolean delaySchedule(uint32_t g_pid);                  // Reset the given schedule to its period and enable it.
+
+    /* Coalescing hint: aligns the given schedule's next firing with buddy's, so the
+     * pair (and anything else coalesced onto buddy) wakes on the same tick from here
+     * on. The opposite of phase spreading, and deliberately so: tasks that share a
+     * peripheral wake-up (a radio, a sensor bus) cost less grouped onto one tick than
+     * spread across several. Same-period pairs stay locked together; differing periods
+     * share only this next firing. */
+    boolean coalesceSchedule(uint32_t g_pid, uint32_t buddy_pid);
     
     boolean willRunAgain(uint32_t g_pid);                  // Returns true if the indicated schedule will fire again.
 
-    void serviceScheduledEvents(void);        // Execute any schedules that have come due.
+#if SCHEDULER_ONESHOT_SLOTS > 0
+    /* One-shot fast path: runs the callback once, on the first tick after delay_ticks
+     * have elapsed, with none of the schedule ceremony (no PID, no list node, no
+     * teardown). Returns a handle for cancelOneShot(), or zero if every slot is
+     * armed. Handles go stale once the one-shot runs or is cancelled; cancelling a
+     * stale handle is a harmless no-op that returns false. */
+    uint32_t runLater(FunctionPointer cb, uint32_t delay_ticks);
+    boolean cancelOneShot(uint32_t handle);
+#endif
+
+    /* Pipelining support. chainSchedule() names a successor to be fired the moment
+     * the given schedule's callback completes, placing it at the tail of its ready
+     * list so a whole pipeline drains in one serviceScheduledEvents() pass (in drain
+     * mode; the legacy one-per-call mode still takes a pass per stage). A successor
+     * PID of zero severs the chain. The successor is usually left disabled so that
+     * only its predecessor triggers it; firing does not touch its countdown.
+     * fireSchedule() is the same primitive exposed directly, and is legal from
+     * inside a callback. */
+    boolean chainSchedule(uint32_t g_pid, uint32_t successor_pid);
+    boolean fireSchedule(uint32_t g_pid);
+
+    void serviceScheduledEvents(void);        // Execute the first schedule that has come due.
+
+    /* Drain mode: keeps dispatching fired schedules until none remain or the given
+     *   microsecond budget is exhausted, whichever comes first. The budget bounds
+     *   worst-case main-loop latency while letting a burst of same-tick expiries
+     *   clear in a single pass instead of one-per-loop. A budget of zero restores
+     *   the legacy one-task-per-call behavior. Note that the budget is only checked
+     *   between callbacks; a single long-running callback can still overshoot it. */
+    void serviceScheduledEvents(uint32_t micros_budget);
+
     void advanceScheduler(void);              // Push all enabled schedules forward by one tick.
+
+    /* Tickless support. Returns how many ticks from now the soonest enabled schedule
+     *   will fire (SCHEDULER_TICKS_INDEFINITE if none will, zero if a firing is
+     *   already pending service). Use it to program a hardware compare-match to the
+     *   exact next deadline and sleep the MCU between events, then make up the gap
+     *   with advanceScheduler(nu_ticks) on wake. Check it again (or rely on the
+     *   callback below) after any call that creates, delays, re-periods, enables or
+     *   removes a schedule, since any of those can pull the deadline closer. */
+    uint32_t ticksUntilNextFire(void);
+
+    /* Registers a function to be called with the new ticksUntilNextFire() value
+     *   whenever one of the calls named above moves the deadline, so the compare-match
+     *   can be reprogrammed without polling. The tick paths themselves do not invoke
+     *   it; re-arms that happen while ticks are being delivered are already visible to
+     *   the caller the next time it prepares to sleep. Pass NULL to unregister. */
+    void setDeadlineCallback(DeadlineFunctionPointer cb);
+
+#if SCHEDULER_WATCHDOG_TICKS > 0
+    /* Registers a function to be called when stuck-task supervision trips: once per
+     *   incident, from tick context, with the offending PID and how many ticks it has
+     *   been in flight. Keep it ISR-short — stash the PID somewhere a post-reset boot
+     *   can read it, or stop feeding the hardware watchdog so the reset proceeds with
+     *   the forensics already saved. Pass NULL to unregister. */
+    void setWatchdogCallback(WatchdogFunctionPointer cb);
+#endif
+
+    /* Catch-up variant: advances every schedule by nu_ticks in a single pass, computing
+     *   each schedule's new countdown arithmetically rather than iterating the tick.
+     *   Use it after a long uninterruptible stretch (SD writes, flash erase) instead of
+     *   calling advanceScheduler() in a loop. Schedules whose period elapsed more than
+     *   once during the gap follow their missed-event policy: under COALESCE (the
+     *   default) those firings collapse into one pending execution; under ACCUMULATE
+     *   every elapsed firing is owed, same as tick-at-a-time delivery. */
+    void advanceScheduler(uint32_t nu_ticks);
     
     /* The functions below return a malloc'd string. So be careful to free() the result
      *   once you have finished with it. No functionality depends on these functions, and 
      *   they are a bit heavy (depend on sprintf). There is no harm in removing them from 
      *   the library if you are space-constrained. 
      */
+    /* Streaming counterparts to the dump functions below. These emit one line at a time
+     *   from a small fixed stack buffer straight into the given Print sink (Serial, a
+     *   file, whatever), so memory use is constant regardless of how many schedules are
+     *   defined, there is no quadratic strcat() rebuilding, and nothing to free().
+     *   Prefer these in production; the dump functions put a line per schedule on the
+     *   stack all at once and will overflow small stacks at large schedule counts.
+     */
+    void printScheduleData(Print &output);                       // Streams schedule data for all defined schedules.
+    void printScheduleData(Print &output, uint32_t g_pid);       // Streams schedule data for the given PID.
+    void printScheduleData(Print &output, uint32_t g_pid, boolean active_only);
+    void printProfilingData(Print &output);                      // Streams profiling data for all profiled schedules.
+    void printProfilingData(Print &output, uint32_t g_pid);      // Streams profiling data for the given PID.
+
     char* dumpAllActiveScheduleData(void);                       // Dumps schedule data for all active schedules.
     char* dumpScheduleData(void);                                // Dumps schedule data for all defined schedules. Active or not.
     char* dumpScheduleData(uint32_t g_pid);                      // Dumps schedule data for the schedule with the given PID.
@@ -147,6 +649,15 @@ class Scheduler {
     char* dumpProfilingData(uint32_t g_pid);                     // Dumps profiling data for the schedule with the given PID.
     char* dumpScheduleData(uint32_t g_pid, boolean active_only); // Dumps schedule data for all defined schedules. Active or not.
 
+    /* Binary counterpart to the profiling dumps, for continuous telemetry rather than
+     *   interactive reading: packs one ScheduleProfileRecord per profiled schedule into
+     *   the given buffer in a single pass — no formatting, no allocation — and returns
+     *   the bytes written (a multiple of sizeof(ScheduleProfileRecord)). Records that
+     *   do not fit whole are left out, so a small buffer yields a truncated but
+     *   well-formed snapshot. The filled buffer can be handed to a UART or radio DMA
+     *   as-is. The text dumps above remain the tool for humans at a console. */
+    size_t exportProfileSnapshot(uint8_t* buf, size_t len);
+
   private:
     boolean scheduleBeingProfiled(ScheduleItem *obj);
     void beginProfiling(ScheduleItem *obj);
@@ -155,11 +666,59 @@ class Scheduler {
     
     boolean alterSchedule(ScheduleItem *obj, uint32_t sch_period, int16_t recurrence, boolean auto_clear, FunctionPointer sch_callback);
 
+    uint32_t createScheduleRaw(uint32_t sch_period, int16_t recurrence, boolean auto_clear, FunctionPointer sch_callback, ArgFunctionPointer arg_cb, void* arg, uint32_t phase);
+
     boolean insertScheduleItemAfterNode(ScheduleItem *nu, ScheduleItem *prev);
     boolean insertScheduleItemAtEnd(ScheduleItem *obj);
     void destroyAllScheduleItems(void);
 
-    uint32_t get_valid_new_pid(void);    
+#if SCHEDULER_WHEEL_BUCKETS > 0
+    void wheelInsert(ScheduleItem *obj, uint32_t ticks_out);   // Files the item into the bucket it expires in.
+    void wheelRemove(ScheduleItem *obj);                       // Unlinks the item from its bucket, if it is in one.
+#endif
+
+#if SCHEDULER_DELTA_QUEUE
+    void deltaInsert(ScheduleItem *obj, uint32_t ticks_out);   // Ordered insertion into the delta chain.
+    void deltaRemove(ScheduleItem *obj);                       // Unlinks the item, repairing the successor's delta.
+#endif
+
+    /* Tick-path maintenance, called wherever a schedule's expiry changes. In the wheel
+       and delta modes these (re)file the item in the auxiliary expiry structure; in the
+       default linear mode they compile to nothing. Attach implies detach first. */
+    void tickPathAttach(ScheduleItem *obj, uint32_t ticks_out);
+    void tickPathDetach(ScheduleItem *obj);
+    uint32_t ticksRemaining(ScheduleItem *obj);
+
+#if SCHEDULER_ISR_SAFE
+    boolean isrRingPush(ScheduleItem *obj);        // ISR side: publish a due node. False if the ring is full.
+    ScheduleItem* isrRingPop(void);                // Main-loop side: take the next due node, or NULL.
+#endif
+
+    void reapDeadSchedules(void);                  // Deferred teardown: unlinks and recycles dead nodes in one sweep.
+    boolean groupPermits(ScheduleItem *obj);       // Is the item's group (if any) unmuted?
+    void stampFire(ScheduleItem *obj);             // Profiler hook at expiry: latency timestamp or missed-fire count.
+    void fireNow(ScheduleItem *obj);               // Main-loop-side fire: marks and queues the item directly.
+    uint32_t reloadTTW(ScheduleItem *obj);         // Computes the countdown for a schedule's next firing.
+    void notifyDeadlineChange(void);               // Runs the deadline callback, if one is registered.
+    void publishFire(ScheduleItem *obj);           // Marks a schedule fired and hands it to the service side.
+    void readyQueuePush(ScheduleItem *obj);        // Appends a freshly-fired schedule to the ready-queue.
+    ScheduleItem* readyQueuePop(void);             // Detaches and returns the oldest fired schedule, or NULL.
+    void readyQueueRemove(ScheduleItem *obj);      // Unlinks the given item from the ready-queue, if queued.
+
+#if SCHEDULER_PID_TABLE_SIZE > 0
+    void pidIndexInsert(ScheduleItem *obj);        // Files the node into the PID index.
+    void pidIndexRemove(uint32_t g_pid);           // Tombstones the given PID in the index.
+    ScheduleItem* pidIndexLookup(uint32_t g_pid);  // O(1) index probe. NULL means "not indexed", not "absent".
+#endif
+
+    /* All ScheduleItem storage passes through these two functions, which either hit
+       the heap or the static pool, depending on SCHEDULER_POOL_SIZE. */
+    ScheduleItem* acquireScheduleItem(void);
+    void releaseScheduleItem(ScheduleItem *obj);
+
+#if SCHEDULER_POOL_SIZE == 0
+    uint32_t get_valid_new_pid(void);
+#endif
     ScheduleItem* findNodeByPID(uint32_t g_pid);
     ScheduleItem* findNodeBeforeThisOne(ScheduleItem *obj);
     void destroyScheduleItem(ScheduleItem *r_node);
@@ -0,0 +1,113 @@
+/*
+File:   StaticScheduler.h
+Author: J. Ian Lindsay
+
+A compile-time companion to the Scheduler class, for the (common) case where the
+schedule table is fixed at build time and never changes. The table is expressed as
+template parameters, so the tick and dispatch loops are generated with every period
+as a compile-time constant: no linked list, no PID lookup, no heap, and the compiler
+is free to unroll the whole tick pass into a run of constant compares. All state is
+a countdown and a pending flag per task, living wherever the StaticScheduler object
+does (.bss, for the usual file-scope instance).
+
+Dynamic schedules can coexist alongside this: keep a regular Scheduler for the
+schedules that come and go, and a StaticScheduler for the fixed hot set. Drive both
+from the same tick source.
+
+Requires C++11 (variadic templates), which every Arduino toolchain recent enough
+for the ARM targets provides.
+
+Copyright (C) 2013 J. Ian Lindsay
+All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef STATIC_SCHEDULER_H
+#define STATIC_SCHEDULER_H
+
+#include <inttypes.h>
+#include "Arduino.h"
+
+
+/**
+* One row of the static table. PERIOD follows the same countdown semantics as the
+*  dynamic Scheduler: the task fires every (PERIOD + 1) ticks, so the two classes
+*  stay interchangeable for a given period value.
+*
+* Usage:
+*   StaticScheduler<StaticTask<499,  sample_cb>,
+*                   StaticTask<999,  report_cb>> table;
+*   ...table.advanceScheduler() from the tick ISR, table.serviceScheduledEvents()
+*   from the main loop, exactly as with the dynamic class.
+*/
+template <uint32_t PERIOD, void (*CALLBACK)(void)>
+struct StaticTask {
+  static const uint32_t period = PERIOD;
+  static inline void invoke() { CALLBACK(); }
+};
+
+
+/* The empty table terminates the recursion. Its passes do nothing and vanish. */
+template <typename... TASKS>
+class StaticScheduler {
+  public:
+    static const uint16_t TASK_COUNT = 0;
+    inline void advanceScheduler() {}
+    inline void serviceScheduledEvents() {}
+};
+
+
+/* Each additional task contributes one countdown/flag pair and one constant-period
+   compare to each pass, chained by inheritance so the compiler sees the whole set
+   as straight-line code. */
+template <typename TASK, typename... REST>
+class StaticScheduler<TASK, REST...> : public StaticScheduler<REST...> {
+  typedef StaticScheduler<REST...> super;
+  uint32_t thread_time_to_wait;
+  boolean  thread_fire;
+
+  public:
+    static const uint16_t TASK_COUNT = 1 + super::TASK_COUNT;
+
+    StaticScheduler() : thread_time_to_wait(TASK::period), thread_fire(false) {}
+
+    /**
+    * Push every task forward by one tick. Same countdown semantics as the dynamic
+    *  class: a task fires on the tick after its countdown reaches zero, and a firing
+    *  that has not been serviced yet coalesces with the next rather than stacking.
+    */
+    inline void advanceScheduler() {
+      if (this->thread_time_to_wait > 0) this->thread_time_to_wait--;
+      else {
+        this->thread_time_to_wait = TASK::period;
+        this->thread_fire = true;
+      }
+      super::advanceScheduler();
+    }
+
+    /**
+    * Run the callback of every task with a pending firing, in table order.
+    */
+    inline void serviceScheduledEvents() {
+      if (this->thread_fire) {
+        this->thread_fire = false;
+        TASK::invoke();
+      }
+      super::serviceScheduledEvents();
+    }
+};
+
+#endif  // STATIC_SCHEDULER_H
@@ -0,0 +1,143 @@
+/*
+File:   SchedulerBenchmark.ino
+Author: J. Ian Lindsay
+
+On-target counterpart to extras/bench: measures the same scheduler costs on real
+hardware and prints CSV over Serial, one row per measurement:
+
+    benchmark,param,value,unit
+
+Schedule counts are scaled down to fit small-RAM targets. Compare rows against a
+host run (or a run from before a change) to see what a configuration or code
+change actually costs on your board.
+
+Copyright (C) 2013 J. Ian Lindsay
+All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Arduino.h"
+
+#ifndef SCHEDULER_H
+#include <Scheduler/Scheduler.h>
+#endif
+
+static void idle_cb() {}
+
+
+void emit(const char* benchmark, long param, float value, const char* unit) {
+  Serial.print(benchmark);
+  Serial.print(",");
+  Serial.print(param);
+  Serial.print(",");
+  Serial.print(value);
+  Serial.print(",");
+  Serial.println(unit);
+}
+
+
+/* advanceScheduler() cost per tick versus schedule count. */
+void bench_advance(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 10000;
+  uint32_t t0 = micros();
+  for (long i = 0; i < iterations; i++) s.advanceScheduler();
+  uint32_t t1 = micros();
+  emit("advance_tick", count, (1000.0 * (t1 - t0)) / iterations, "ns");
+}
+
+
+/* serviceScheduledEvents() with nothing pending. */
+void bench_service_empty(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 10000;
+  uint32_t t0 = micros();
+  for (long i = 0; i < iterations; i++) s.serviceScheduledEvents(0);
+  uint32_t t1 = micros();
+  emit("service_empty", count, (1000.0 * (t1 - t0)) / iterations, "ns");
+}
+
+
+/* createSchedule()/removeSchedule() round trips per second. */
+void bench_churn(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 2000;
+  uint32_t t0 = micros();
+  for (long i = 0; i < iterations; i++) {
+    uint32_t pid = s.createSchedule(1000000, -1, false, idle_cb);
+    s.removeSchedule(pid);
+  }
+  uint32_t t1 = micros();
+  emit("create_remove", count, (1000000.0 * iterations) / (t1 - t0), "ops_per_s");
+}
+
+
+/* PID lookup latency versus position in the schedule list. */
+void bench_find(int count) {
+  Scheduler s;
+  uint32_t first = 0, middle = 0, last = 0;
+  for (int i = 0; i < count; i++) {
+    uint32_t pid = s.createSchedule(1000000, -1, false, idle_cb);
+    if (i == 0) first = pid;
+    if (i == (count / 2)) middle = pid;
+    last = pid;
+  }
+  const long iterations = 10000;
+  uint32_t probe_pids[3] = {first, middle, last};
+  const char* probe_names[3] = {"find_pid_front", "find_pid_middle", "find_pid_back"};
+  for (int p = 0; p < 3; p++) {
+    uint32_t t0 = micros();
+    for (long i = 0; i < iterations; i++) s.scheduleEnabled(probe_pids[p]);
+    uint32_t t1 = micros();
+    emit(probe_names[p], count, (1000.0 * (t1 - t0)) / iterations, "ns");
+  }
+}
+
+
+/* Dump-function memory cost: heap for the output, stack for assembling it. */
+void bench_dump(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  char* out = s.dumpScheduleData();
+  if (out != NULL) {
+    emit("dump_heap_bytes", count, strlen(out) + 1, "bytes");
+    free(out);
+  }
+  emit("dump_stack_bytes", count, 150.0 * (count + 1), "bytes");
+}
+
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println("benchmark,param,value,unit");
+  bench_advance(5);
+  bench_advance(20);
+  bench_advance(50);
+  bench_service_empty(20);
+  bench_churn(5);
+  bench_churn(20);
+  bench_find(50);
+  bench_dump(20);
+  Serial.println("done");
+}
+
+
+void loop() {
+}
@@ -0,0 +1,160 @@
+/*
+File:   extras/bench/bench.cpp
+Author: J. Ian Lindsay
+
+Host-side benchmark harness for the Scheduler. Builds against the shim in
+extras/host (see the Makefile here) and prints one CSV row per measurement to
+stdout:
+
+    benchmark,param,value,unit
+
+Measured:
+  - advanceScheduler() cost versus schedule count (10/100/1000)
+  - serviceScheduledEvents() overhead with nothing pending
+  - createSchedule()/removeSchedule() churn throughput
+  - PID lookup latency versus list position (front/middle/back)
+  - dump-function output size (heap) and worst-case stack estimate
+
+Wall-clock timing uses the host's monotonic clock; the scheduler itself runs on
+the simulated micros() from the shim, so its internal measurements stay inert.
+Run the same figures on hardware with examples/SchedulerBenchmark. Keep a CSV
+from before a change and diff it against one from after; that is the whole
+regression story.
+
+Copyright (C) 2013 J. Ian Lindsay
+All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <Arduino.h>
+#include <Scheduler/Scheduler.h>
+#include <time.h>
+
+uint32_t host_fake_micros = 0;
+
+static void idle_cb() {}
+
+
+/* Monotonic wall-clock, in nanoseconds. */
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000000000ull) + ts.tv_nsec;
+}
+
+
+static void emit(const char* benchmark, long param, double value, const char* unit) {
+  printf("%s,%ld,%.1f,%s\n", benchmark, param, value, unit);
+}
+
+
+/* advanceScheduler() cost per tick, as a function of how many schedules exist.
+   Periods are set far out so the measurement is the walk itself, not dispatch. */
+static void bench_advance(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 4000000l / count;
+  uint64_t t0 = now_ns();
+  for (long i = 0; i < iterations; i++) s.advanceScheduler();
+  uint64_t t1 = now_ns();
+  emit("advance_tick", count, (double) (t1 - t0) / iterations, "ns");
+}
+
+
+/* serviceScheduledEvents() with nothing pending: the fixed per-loop tax. */
+static void bench_service_empty(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 1000000l;
+  uint64_t t0 = now_ns();
+  for (long i = 0; i < iterations; i++) s.serviceScheduledEvents(0);
+  uint64_t t1 = now_ns();
+  emit("service_empty", count, (double) (t1 - t0) / iterations, "ns");
+}
+
+
+/* createSchedule()/removeSchedule() round trips per second, at a standing
+   population of `count` schedules. */
+static void bench_churn(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  const long iterations = 200000l;
+  uint64_t t0 = now_ns();
+  for (long i = 0; i < iterations; i++) {
+    uint32_t pid = s.createSchedule(1000000, -1, false, idle_cb);
+    s.removeSchedule(pid);
+  }
+  uint64_t t1 = now_ns();
+  emit("create_remove", count, 1e9 * iterations / (double) (t1 - t0), "ops_per_s");
+}
+
+
+/* PID lookup cost versus where the schedule sits in the list. The index only holds
+   SCHEDULER_PID_TABLE_SIZE entries (64 by default), so at a count the table covers
+   all three rows should be flat; past that, later-created schedules go unindexed
+   and fall back to the list walk, so the middle and back rows climb linearly. With
+   the index compiled out entirely, every row climbs. main() runs both a covered
+   count and an overflowing one so a CSV shows each regime. */
+static void bench_find(int count) {
+  Scheduler s;
+  uint32_t first = 0, middle = 0, last = 0;
+  for (int i = 0; i < count; i++) {
+    uint32_t pid = s.createSchedule(1000000, -1, false, idle_cb);
+    if (i == 0) first = pid;
+    if (i == (count / 2)) middle = pid;
+    last = pid;
+  }
+  const long iterations = 1000000l;
+  struct { const char* name; uint32_t pid; } probes[] = {
+    {"find_pid_front", first}, {"find_pid_middle", middle}, {"find_pid_back", last}
+  };
+  for (int p = 0; p < 3; p++) {
+    uint64_t t0 = now_ns();
+    for (long i = 0; i < iterations; i++) s.scheduleEnabled(probes[p].pid);
+    uint64_t t1 = now_ns();
+    emit(probes[p].name, count, (double) (t1 - t0) / iterations, "ns");
+  }
+}
+
+
+/* Dump functions: how much they cost in memory, not time. The malloc'd dump
+   builds the whole report on the stack first (150 bytes per line), which is the
+   figure that matters on a small target. */
+static void bench_dump(int count) {
+  Scheduler s;
+  for (int i = 0; i < count; i++) s.createSchedule(1000000, -1, false, idle_cb);
+  char* out = s.dumpScheduleData();
+  if (out != NULL) {
+    emit("dump_heap_bytes", count, (double) (strlen(out) + 1), "bytes");
+    free(out);
+  }
+  emit("dump_stack_bytes", count, 150.0 * (count + 1), "bytes");
+}
+
+
+int main() {
+  printf("benchmark,param,value,unit\n");
+  bench_advance(10);
+  bench_advance(100);
+  bench_advance(1000);
+  bench_service_empty(100);
+  bench_churn(10);
+  bench_churn(100);
+  bench_find(50);
+  bench_find(1000);
+  bench_dump(100);
+  return 0;
+}
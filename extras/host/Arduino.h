@@ -0,0 +1,70 @@
+/*
+File:   extras/host/Arduino.h
+Author: J. Ian Lindsay
+
+A minimal stand-in for the Arduino core, sufficient to build the Scheduler on a
+desktop machine. The point is fast iteration: benchmarks, soak tests and profiler
+runs (perf, cachegrind) against the real scheduler code without hardware in the
+loop.
+
+The clock is simulated: micros()/millis() read a plain counter that the harness
+advances however it likes (see VirtualClock.h), so a million ticks of simulated
+uptime cost milliseconds of wall-clock. Exactly one translation unit in the host
+program must define host_fake_micros.
+
+Copyright (C) 2013 J. Ian Lindsay
+All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef bool boolean;
+
+/* The simulated clock. The harness owns this; the library only ever reads it. */
+extern uint32_t host_fake_micros;
+
+static inline uint32_t micros() { return host_fake_micros; }
+static inline uint32_t millis() { return host_fake_micros / 1000; }
+
+#ifndef min
+  #define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+  #define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+/* Just enough of Print for the streaming dump functions. Output goes to stdout. */
+class Print {
+  public:
+    virtual size_t write(uint8_t b) { return (fputc(b, stdout) >= 0) ? 1 : 0; }
+    virtual size_t write(const uint8_t* buf, size_t len) {
+      size_t n = 0;
+      while (n < len) { if (this->write(buf[n]) == 0) break; n++; }
+      return n;
+    }
+    size_t print(const char* s)   { return this->write((const uint8_t*) s, strlen(s)); }
+    size_t println(const char* s) { size_t n = this->print(s); n += this->write((uint8_t) '\n'); return n; }
+    size_t println()              { return this->write((uint8_t) '\n'); }
+};
+
+#endif  // HOST_ARDUINO_SHIM_H